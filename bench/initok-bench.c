@@ -0,0 +1,296 @@
+/** @file initok-bench.c
+ *
+ * ssu-sysinfo - Ini file tokenizer benchmark
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Compares the single pass tokenizer against the original approach of
+ * trimming, slicing and stripping each line separately. Both parsers
+ * are fed the same generated corpus and must produce identical tokens.
+ *
+ * Additionally reports throughput of building a complete inifile_t
+ * via inifile_load_buffer(), i.e. parsing without any file I/O.
+ *
+ * Usage: initok-bench [corpus-megabytes] [rounds]
+ */
+
+#include "../lib/inifile.h"
+#include "../lib/initok.h"
+#include "../lib/util.h"
+#include "../lib/xmalloc.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static double    bench_now        (void);
+static uint64_t  bench_mix        (uint64_t hash, int type, const char *key, const char *val);
+static char     *bench_corpus     (size_t want, size_t *psize);
+static uint64_t  bench_legacy     (char *data, size_t size, bool unquote);
+static uint64_t  bench_initok     (char *data, size_t size, bool unquote);
+static double    bench_run        (uint64_t (*parse)(char *, size_t, bool),
+                                   const char *corpus, char *work, size_t size,
+                                   int rounds, bool unquote, uint64_t *phash);
+static double    bench_inifile    (const char *corpus, size_t size, int rounds,
+                                   bool unquote);
+int              main             (int argc, char **argv);
+
+/* ========================================================================= *
+ * Utilities
+ * ========================================================================= */
+
+static double
+bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** Accumulate FNV-1a hash over emitted tokens
+ */
+static uint64_t
+bench_mix(uint64_t hash, int type, const char *key, const char *val)
+{
+    hash = (hash ^ (unsigned)type) * 0x100000001b3ull;
+    for( const char *str = key; *str; ++str )
+        hash = (hash ^ (unsigned char)*str) * 0x100000001b3ull;
+    hash = (hash ^ 0xff) * 0x100000001b3ull;
+    for( const char *str = val ?: ""; *str; ++str )
+        hash = (hash ^ (unsigned char)*str) * 0x100000001b3ull;
+    return hash;
+}
+
+/** Generate ini content resembling board mappings, with some noise
+ */
+static char *
+bench_corpus(size_t want, size_t *psize)
+{
+    static const char * const pad[] = { "", "", "", " ", "  ", "\t", " \t " };
+    static const char * const val[] = {
+        "value", "some longer value with spaces", "'quoted value'",
+        "\"double quoted\"", "", "a=b=c", "/usr/share/ssu/features.d",
+    };
+
+    size_t  size = 0;
+    size_t  have = want + 256;
+    char   *data = xmalloc(have + 1);
+    int     line = 0;
+
+    srand(42);
+
+    while( size < want ) {
+        int r = rand();
+        const char *p1 = pad[r % 7];
+        const char *p2 = pad[(r >> 3) % 7];
+        const char *p3 = pad[(r >> 6) % 7];
+        int n = 0;
+
+        switch( r % 16 ) {
+        case 0:
+            n = snprintf(data + size, have - size, "%s[section %d]%s\n",
+                         p1, line, p2);
+            break;
+        case 1:
+            n = snprintf(data + size, have - size, "# comment line %d\n", line);
+            break;
+        case 2:
+            n = snprintf(data + size, have - size, "\n");
+            break;
+        default:
+            n = snprintf(data + size, have - size, "%skey%d%s=%s%s\r\n",
+                         p1, line % 97, p2, p3, val[(r >> 9) % 7]);
+            break;
+        }
+        if( n < 0 || (size_t)n >= have - size )
+            break;
+        size += (size_t)n;
+        ++line;
+    }
+
+    data[size] = 0;
+    *psize = size;
+    return data;
+}
+
+/* ========================================================================= *
+ * Parsers
+ * ========================================================================= */
+
+/** Line by line parsing, as inifile_load() used to do it
+ */
+static uint64_t
+bench_legacy(char *data, size_t size, bool unquote)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    char    *end  = data + size;
+
+    for( char *pos = data; pos < end; ) {
+        char *eol = memchr(pos, '\n', (size_t)(end - pos)) ?: end;
+        *eol = 0;
+
+        char *line = strutil_trim(pos);
+        pos = eol + 1;
+
+        if( *line == 0 || *line == ';' || *line == '#' )
+            continue;
+
+        if( *line == '[' ) {
+            char *name = strutil_slice(line + 1, 0, ']');
+            hash = bench_mix(hash, INITOK_SECTION, strutil_strip(name), 0);
+            continue;
+        }
+
+        char *val = 0;
+        char *key = strutil_slice(line, &val, '=');
+        strutil_strip(key);
+        strutil_trim(val);
+
+        if( !*key )
+            continue;
+
+        if( unquote && (*val == '"' || *val == '\'') ) {
+            char *quote = strrchr(val + 1, *val);
+            if( quote ) {
+                *quote = 0;
+                strutil_trim(++val);
+            }
+        }
+        hash = bench_mix(hash, INITOK_ENTRY, key, val);
+    }
+
+    return hash;
+}
+
+/** Single pass tokenizer
+ */
+static uint64_t
+bench_initok(char *data, size_t size, bool unquote)
+{
+    uint64_t      hash = 0xcbf29ce484222325ull;
+    initok_t      tok;
+    initok_type_t type;
+    char         *key, *val;
+
+    initok_ctor(&tok, data, size, unquote);
+
+    while( (type = initok_next(&tok, &key, &val)) != INITOK_EOF )
+        hash = bench_mix(hash, type, key, val);
+
+    return hash;
+}
+
+/* ========================================================================= *
+ * Benchmark
+ * ========================================================================= */
+
+/** Run parser over fresh copies of the corpus
+ *
+ * @return throughput in megabytes per second
+ */
+static double
+bench_run(uint64_t (*parse)(char *, size_t, bool),
+          const char *corpus, char *work, size_t size,
+          int rounds, bool unquote, uint64_t *phash)
+{
+    double spent = 0;
+
+    for( int i = 0; i < rounds; ++i ) {
+        /* Parsing is done in place; copying is not part of the cost */
+        memcpy(work, corpus, size + 1);
+
+        double t0 = bench_now();
+        *phash = parse(work, size, unquote);
+        spent += bench_now() - t0;
+    }
+
+    return (double)size * rounds / spent / (1024 * 1024);
+}
+
+/** Load the corpus into an inifile_t repeatedly
+ *
+ * @return throughput in megabytes per second
+ */
+static double
+bench_inifile(const char *corpus, size_t size, int rounds, bool unquote)
+{
+    double     spent = 0;
+    inifile_t *ini   = inifile_create();
+
+    for( int i = 0; i < rounds; ++i ) {
+        double t0 = bench_now();
+        inifile_load_buffer(ini, corpus, size, unquote ? "default" : 0);
+        spent += bench_now() - t0;
+        inifile_reset(ini);
+    }
+
+    inifile_delete(ini);
+
+    return (double)size * rounds / spent / (1024 * 1024);
+}
+
+int
+main(int argc, char **argv)
+{
+    int     exit_code = EXIT_FAILURE;
+    size_t  megs      = (argc > 1) ? strtoul(argv[1], 0, 0) : 16;
+    int     rounds    = (argc > 2) ? atoi(argv[2]) : 10;
+    size_t  size      = 0;
+    char   *corpus    = bench_corpus(megs << 20, &size);
+    char   *work      = xmalloc(size + 1);
+
+#ifdef __SSE2__
+    const char *impl = "sse2";
+#else
+    const char *impl = "scalar";
+#endif
+
+    printf("corpus: %zu bytes, %d rounds, tokenizer: %s\n", size, rounds, impl);
+
+    for( int unquote = 0; unquote < 2; ++unquote ) {
+        uint64_t h_old = 0;
+        uint64_t h_new = 0;
+        double   r_old = bench_run(bench_legacy, corpus, work, size,
+                                   rounds, unquote, &h_old);
+        double   r_new = bench_run(bench_initok, corpus, work, size,
+                                   rounds, unquote, &h_new);
+
+        printf("unquote=%d  legacy: %8.1f MB/s  initok: %8.1f MB/s  "
+               "speedup: %.2fx  %s\n", unquote, r_old, r_new, r_new / r_old,
+               h_old == h_new ? "tokens match" : "TOKENS DIFFER");
+
+        if( h_old != h_new )
+            goto EXIT;
+
+        printf("unquote=%d  inifile_load_buffer: %8.1f MB/s\n", unquote,
+               bench_inifile(corpus, size, rounds, unquote));
+    }
+
+    exit_code = EXIT_SUCCESS;
+
+EXIT:
+    free(work);
+    free(corpus);
+    return exit_code;
+}
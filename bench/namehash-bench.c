@@ -0,0 +1,271 @@
+/** @file namehash-bench.c
+ *
+ * ssu-sysinfo - Name lookup benchmark
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Compares perfect hash lookups of hw key and hw feature names against
+ * the original approach of scanning the name tables with strcasecmp().
+ * Queries consist of all known names in original, lower and upper case,
+ * and an equal number of unknown names. Both approaches must resolve
+ * every query to the same result.
+ *
+ * Usage: namehash-bench [rounds]
+ */
+
+#include "../lib/hw_feature.h"
+#include "../lib/hw_key.h"
+#include "../lib/xmalloc.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static double        bench_now          (void);
+static char        **bench_queries      (const char **names, size_t *pcount);
+static void          bench_free_queries (char **queries, size_t count);
+static hw_key_t      bench_key_legacy   (const char *name);
+static hw_key_t      bench_key_hashed   (const char *name);
+static hw_feature_t  bench_feature_legacy(const char *name);
+static hw_feature_t  bench_feature_hashed(const char *name);
+static double        bench_run          (uint32_t (*lookup)(const char *),
+                                         char **queries, size_t count,
+                                         int rounds, uint64_t *psum);
+static uint32_t      bench_key_legacy_cb (const char *name);
+static uint32_t      bench_key_hashed_cb (const char *name);
+static uint32_t      bench_feature_legacy_cb(const char *name);
+static uint32_t      bench_feature_hashed_cb(const char *name);
+static bool          bench_table        (const char *title, const char **names,
+                                         uint32_t (*legacy)(const char *),
+                                         uint32_t (*hashed)(const char *),
+                                         int rounds);
+int                  main               (int argc, char **argv);
+
+/* ========================================================================= *
+ * Utilities
+ * ========================================================================= */
+
+static double
+bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** Generate query names from a NULL terminated name array
+ */
+static char **
+bench_queries(const char **names, size_t *pcount)
+{
+    size_t   n   = 0;
+    size_t   k   = 0;
+
+    while( names[n] )
+        ++n;
+
+    char **queries = xcalloc(n * 4, sizeof *queries);
+
+    for( size_t i = 0; i < n; ++i ) {
+        char *lower = xstrdup(names[i]);
+        char *upper = xstrdup(names[i]);
+        char *miss  = xmalloc(strlen(names[i]) + 2);
+
+        for( char *pos = lower; *pos; ++pos )
+            *pos = (char)tolower((unsigned char)*pos);
+        for( char *pos = upper; *pos; ++pos )
+            *pos = (char)toupper((unsigned char)*pos);
+        strcat(strcpy(miss, names[i]), "X");
+
+        queries[k++] = xstrdup(names[i]);
+        queries[k++] = lower;
+        queries[k++] = upper;
+        queries[k++] = miss;
+    }
+
+    *pcount = k;
+    return queries;
+}
+
+static void
+bench_free_queries(char **queries, size_t count)
+{
+    for( size_t i = 0; i < count; ++i )
+        free(queries[i]);
+    free(queries);
+}
+
+/* ========================================================================= *
+ * Lookup functions
+ * ========================================================================= */
+
+/** Linear scan, as hw_key_from_string() used to do
+ */
+static hw_key_t
+bench_key_legacy(const char *name)
+{
+    static const char **names = 0;
+
+    if( !names )
+        names = hw_key_names();
+
+    for( size_t i = 0; names[i]; ++i ) {
+        if( !strcasecmp(names[i], name) )
+            return hw_key_from_string(names[i]);
+    }
+    return 0;
+}
+
+static hw_key_t
+bench_key_hashed(const char *name)
+{
+    return hw_key_from_string(name);
+}
+
+/** Linear scan, as hw_feature_from_string() used to do
+ */
+static hw_feature_t
+bench_feature_legacy(const char *name)
+{
+    for( hw_feature_t i = 0; i < Feature_Count; ++i ) {
+        if( !strcasecmp(hw_feature_to_string(i), name) )
+            return i;
+    }
+    return Feature_Invalid;
+}
+
+static hw_feature_t
+bench_feature_hashed(const char *name)
+{
+    return hw_feature_from_string(name);
+}
+
+static uint32_t bench_key_legacy_cb(const char *name)
+{
+    return bench_key_legacy(name);
+}
+
+static uint32_t bench_key_hashed_cb(const char *name)
+{
+    return bench_key_hashed(name);
+}
+
+static uint32_t bench_feature_legacy_cb(const char *name)
+{
+    return (uint32_t)bench_feature_legacy(name);
+}
+
+static uint32_t bench_feature_hashed_cb(const char *name)
+{
+    return (uint32_t)bench_feature_hashed(name);
+}
+
+/* ========================================================================= *
+ * Benchmark
+ * ========================================================================= */
+
+/** Resolve all queries repeatedly
+ *
+ * @return lookups per microsecond
+ */
+static double
+bench_run(uint32_t (*lookup)(const char *), char **queries, size_t count,
+          int rounds, uint64_t *psum)
+{
+    uint64_t sum = 0;
+    double   t0  = bench_now();
+
+    for( int r = 0; r < rounds; ++r ) {
+        for( size_t i = 0; i < count; ++i )
+            sum = sum * 31 + lookup(queries[i]);
+    }
+
+    double spent = bench_now() - t0;
+
+    *psum = sum;
+    return (double)count * rounds / spent * 1e-6;
+}
+
+/** Benchmark and cross check lookups from one name table
+ *
+ * @return true if both approaches gave identical results
+ */
+static bool
+bench_table(const char *title, const char **names,
+            uint32_t (*legacy)(const char *),
+            uint32_t (*hashed)(const char *), int rounds)
+{
+    size_t   count   = 0;
+    char   **queries = bench_queries(names, &count);
+    uint64_t s_old   = 0;
+    uint64_t s_new   = 0;
+    bool     ack     = true;
+
+    for( size_t i = 0; i < count; ++i ) {
+        if( legacy(queries[i]) != hashed(queries[i]) ) {
+            printf("%s: MISMATCH for '%s'\n", title, queries[i]);
+            ack = false;
+        }
+    }
+
+    double r_old = bench_run(legacy, queries, count, rounds, &s_old);
+    double r_new = bench_run(hashed, queries, count, rounds, &s_new);
+
+    printf("%-8s %4zu queries  legacy: %8.2f M/s  hashed: %8.2f M/s  "
+           "speedup: %.1fx  %s\n", title, count, r_old, r_new,
+           r_new / r_old, s_old == s_new ? "results match" : "RESULTS DIFFER");
+
+    bench_free_queries(queries, count);
+
+    return ack && s_old == s_new;
+}
+
+int
+main(int argc, char **argv)
+{
+    int          exit_code = EXIT_FAILURE;
+    int          rounds    = (argc > 1) ? atoi(argv[1]) : 200;
+    const char **keys      = hw_key_names();
+    const char **features  = hw_feature_names();
+
+    printf("rounds: %d\n", rounds);
+
+    if( !bench_table("keys", keys, bench_key_legacy_cb,
+                     bench_key_hashed_cb, rounds) )
+        goto EXIT;
+
+    if( !bench_table("features", features, bench_feature_legacy_cb,
+                     bench_feature_hashed_cb, rounds) )
+        goto EXIT;
+
+    exit_code = EXIT_SUCCESS;
+
+EXIT:
+    free(features);
+    free(keys);
+
+    return exit_code;
+}
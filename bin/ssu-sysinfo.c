@@ -60,6 +60,8 @@ static void          output_release                (void);
 static void          output_all                    (void);
 static void          output_device_info            (void);
 static void          output_model                  (void);
+static void          explain_model_cb              (const ssusysinfo_model_rule_t *rule, void *aptr);
+static void          output_explain_model          (void);
 static void          output_designation            (void);
 static void          output_manufacturer           (void);
 static void          output_pretty_name            (void);
@@ -77,6 +79,8 @@ static void          output_hw_version             (void);
 static void          output_hw_pretty_version      (void);
 static void          output_board_version          (void);
 static void          output_hw_info                (void);
+static bool          compile_board_mappings        (const char *path);
+static bool          write_snapshot                (const char *path);
 
 /* ========================================================================= *
  * BITFIELD
@@ -233,6 +237,9 @@ const struct option opt_long[] =
     {"hw-version",              no_argument,       0, 'B'},
     {"hw-pretty-version",       no_argument,       0, 904},
     {"board-version",           no_argument,       0, 905},
+    {"compile-board-mappings",  optional_argument, 0, 906},
+    {"write-snapshot",          optional_argument, 0, 907},
+    {"explain-model",           no_argument,       0, 908},
     {0, 0, 0, 0}
 };
 
@@ -270,6 +277,7 @@ const char opt_help[] =
 "  -h --help                   Print usage information\n"
 "\n"
 "  -m --model                  Print device model\n"
+"  --explain-model             Print device model detection steps\n"
 "  -d --designation            Print device designation\n"
 "  -M --manufacturer           Print device manufacturer\n"
 "  -p --pretty-name            Print device pretty name\n"
@@ -302,6 +310,10 @@ const char opt_help[] =
 "  --hw-pretty-version         Print hw version description\n"
 "  --board-version             Print circuit board version description\n"
 "\n"
+"  --compile-board-mappings[=<PATH>]\n"
+"                              Update compiled board mappings database\n"
+"  --write-snapshot[=<PATH>]   Update snapshot of resolved values\n"
+"\n"
 ;
 
 /** Handler for --help option
@@ -459,6 +471,27 @@ output_model(void)
     printf("%s\n", ssusysinfo_device_model(get_cfg()));
 }
 
+/** Callback for reporting evaluated model detection rules
+ */
+static void
+explain_model_cb(const ssusysinfo_model_rule_t *rule, void *aptr)
+{
+    (void)aptr;
+
+    printf("%-16s %-3s %10.1f us  %s -> %s\n", rule->rule,
+           rule->matched ? "yes" : "no", rule->nsec / 1e3,
+           rule->value, rule->model ?: "N/A");
+}
+
+/** Handler for --explain-model option
+ */
+static void
+output_explain_model(void)
+{
+    ssusysinfo_explain_device_model(get_cfg(), explain_model_cb, 0);
+    printf("model: %s\n", ssusysinfo_device_model(get_cfg()));
+}
+
 /** Handler for --designation option
  */
 static void
@@ -488,12 +521,10 @@ output_pretty_name(void)
 static void
 output_list_hw_features(void)
 {
-    const char **arr = ssusysinfo_hw_feature_names();
+    const char * const *arr = ssusysinfo_hw_feature_name_list();
 
-    for( size_t i = 0; arr && arr[i]; ++i )
+    for( size_t i = 0; arr[i]; ++i )
         printf("%s\n", arr[i]);
-
-    free(arr);
 }
 
 /** Handler for --hw-features option
@@ -523,12 +554,10 @@ require_has_hw_feature(const char *name)
 static void
 output_list_hw_keys(void)
 {
-    const char **arr = ssusysinfo_hw_key_names();
+    const char * const *arr = ssusysinfo_hw_key_name_list();
 
-    for( size_t i = 0; arr && arr[i]; ++i )
+    for( size_t i = 0; arr[i]; ++i )
         printf("%s\n", arr[i]);
-
-    free(arr);
 }
 
 /** Handler for --hw-keys option
@@ -623,6 +652,30 @@ output_hw_info(void)
     printf("board_version: %s\n", ssusysinfo_board_version(info));
 }
 
+/** Handler for --compile-board-mappings option
+ */
+static bool
+compile_board_mappings(const char *path)
+{
+    if( ssusysinfo_compile_board_mappings(path) )
+        return true;
+
+    fprintf(stderr, "failed to compile board mappings\n");
+    return false;
+}
+
+/** Handler for --write-snapshot option
+ */
+static bool
+write_snapshot(const char *path)
+{
+    if( ssusysinfo_write_snapshot(path) )
+        return true;
+
+    fprintf(stderr, "failed to write snapshot\n");
+    return false;
+}
+
 /* ========================================================================= *
  * MAIN_ENTRY_POINT
  * ========================================================================= */
@@ -759,6 +812,20 @@ main(int ac, char **av)
             output_board_version();
             break;
 
+        case 906:
+            if( !compile_board_mappings(optarg) )
+                goto EXIT;
+            break;
+
+        case 907:
+            if( !write_snapshot(optarg) )
+                goto EXIT;
+            break;
+
+        case 908:
+            output_explain_model();
+            break;
+
         case '?':
             fprintf(stderr, "(use --help for instructions)\n");
             goto EXIT;
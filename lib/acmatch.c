@@ -0,0 +1,291 @@
+/** @file acmatch.c
+ *
+ * ssu-sysinfo - Multi-pattern substring matching
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Patterns are identified by the order in which they are added, and
+ * later patterns take precedence over earlier ones: scanning yields
+ * the highest id of all patterns that occur in the input, and stops
+ * reading as soon as the last pattern has been seen.
+ */
+
+#include "acmatch.h"
+
+#include "xmalloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Size of chunks in which input is read */
+#define ACMATCH_CHUNK 4096
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Automaton state, i.e. node in trie of patterns */
+typedef struct
+{
+    uint32_t      as_child;   // first child state, or 0 for none
+    uint32_t      as_sibling; // next child of the parent, or 0 for none
+    uint32_t      as_fail;    // state for the longest proper suffix
+    int           as_best;    // highest pattern id ending here, or -1
+    unsigned char as_byte;    // input byte leading to this state
+} acstate_t;
+
+struct acmatch_t
+{
+    acstate_t *am_state; // states, root at index 0
+    uint32_t   am_count; // number of states
+    uint32_t   am_alloc; // number of allocated states
+    int        am_ids;   // number of patterns added
+};
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static uint32_t  acmatch_goto    (const acmatch_t *self, uint32_t state, unsigned char byte);
+static uint32_t  acmatch_new     (acmatch_t *self, uint32_t parent, unsigned char byte);
+static uint32_t  acmatch_step    (const acmatch_t *self, uint32_t state, unsigned char byte);
+acmatch_t       *acmatch_create  (void);
+void             acmatch_delete  (acmatch_t *self);
+int              acmatch_add     (acmatch_t *self, const char *pattern);
+void             acmatch_compile (acmatch_t *self);
+int              acmatch_scan_fd (const acmatch_t *self, int fd);
+
+/* ========================================================================= *
+ * Trie
+ * ========================================================================= */
+
+/** Get child state for input byte
+ *
+ * @return child state, or 0 if there is none
+ */
+static uint32_t
+acmatch_goto(const acmatch_t *self, uint32_t state, unsigned char byte)
+{
+    uint32_t child = self->am_state[state].as_child;
+
+    while( child && self->am_state[child].as_byte != byte )
+        child = self->am_state[child].as_sibling;
+
+    return child;
+}
+
+/** Add child state for input byte
+ *
+ * @return new child state
+ */
+static uint32_t
+acmatch_new(acmatch_t *self, uint32_t parent, unsigned char byte)
+{
+    if( self->am_count == self->am_alloc ) {
+        self->am_alloc *= 2;
+        self->am_state = xrealloc(self->am_state,
+                                  self->am_alloc * sizeof *self->am_state);
+    }
+
+    uint32_t   child = self->am_count++;
+    acstate_t *state = &self->am_state[child];
+
+    state->as_child   = 0;
+    state->as_sibling = self->am_state[parent].as_child;
+    state->as_fail    = 0;
+    state->as_best    = -1;
+    state->as_byte    = byte;
+
+    self->am_state[parent].as_child = child;
+
+    return child;
+}
+
+/** Advance from a state by one input byte, following failure links
+ *
+ * @return new state
+ */
+static uint32_t
+acmatch_step(const acmatch_t *self, uint32_t state, unsigned char byte)
+{
+    for( ;; ) {
+        uint32_t next = acmatch_goto(self, state, byte);
+        if( next )
+            return next;
+        if( state == 0 )
+            return 0;
+        state = self->am_state[state].as_fail;
+    }
+}
+
+/* ========================================================================= *
+ * Building
+ * ========================================================================= */
+
+/** Create an empty matcher
+ *
+ * @return matcher object, to be released with acmatch_delete()
+ */
+acmatch_t *
+acmatch_create(void)
+{
+    acmatch_t *self = xcalloc(1, sizeof *self);
+
+    self->am_alloc = 64;
+    self->am_state = xcalloc(self->am_alloc, sizeof *self->am_state);
+    self->am_count = 1;
+    self->am_state[0].as_best = -1;
+    self->am_ids   = 0;
+
+    return self;
+}
+
+/** Release matcher
+ *
+ * @param self  matcher object, or NULL
+ */
+void
+acmatch_delete(acmatch_t *self)
+{
+    if( self ) {
+        free(self->am_state);
+        free(self);
+    }
+}
+
+/** Add a pattern
+ *
+ * Patterns must be added before acmatch_compile() is called. An empty
+ * pattern matches any input.
+ *
+ * @param self     matcher object
+ * @param pattern  substring to look for
+ *
+ * @return id of the pattern
+ */
+int
+acmatch_add(acmatch_t *self, const char *pattern)
+{
+    uint32_t state = 0;
+    int      id    = self->am_ids++;
+
+    for( const unsigned char *pos = (const unsigned char *)pattern; *pos; ++pos ) {
+        uint32_t next = acmatch_goto(self, state, *pos);
+        state = next ?: acmatch_new(self, state, *pos);
+    }
+
+    self->am_state[state].as_best = id;
+
+    return id;
+}
+
+/** Compute failure links after all patterns have been added
+ *
+ * States are processed in breadth first order, so that failure links
+ * of shallower states are available when they are needed. Each state
+ * also inherits the best match of its failure state, i.e. matches of
+ * patterns that are suffixes of the current one.
+ *
+ * @param self  matcher object
+ */
+void
+acmatch_compile(acmatch_t *self)
+{
+    uint32_t *queue = xmalloc(self->am_count * sizeof *queue);
+    uint32_t  head  = 0;
+    uint32_t  tail  = 0;
+
+    for( uint32_t child = self->am_state[0].as_child; child;
+         child = self->am_state[child].as_sibling ) {
+        self->am_state[child].as_fail = 0;
+        queue[tail++] = child;
+    }
+
+    while( head < tail ) {
+        uint32_t parent = queue[head++];
+
+        for( uint32_t child = self->am_state[parent].as_child; child;
+             child = self->am_state[child].as_sibling ) {
+            acstate_t *state = &self->am_state[child];
+            uint32_t   fail  = acmatch_step(self,
+                                            self->am_state[parent].as_fail,
+                                            state->as_byte);
+
+            state->as_fail = fail;
+            if( state->as_best < self->am_state[fail].as_best )
+                state->as_best = self->am_state[fail].as_best;
+
+            queue[tail++] = child;
+        }
+    }
+
+    free(queue);
+}
+
+/* ========================================================================= *
+ * Matching
+ * ========================================================================= */
+
+/** Scan file content for patterns
+ *
+ * Input is read in chunks and matched in one pass, so that the cost
+ * is linear in input size regardless of the number of patterns.
+ * Reading stops as soon as the last added pattern has been seen, as
+ * nothing can take precedence over it.
+ *
+ * @param self  compiled matcher object
+ * @param fd    file descriptor to read from
+ *
+ * @return highest id of matching patterns, or -1 if none match
+ */
+int
+acmatch_scan_fd(const acmatch_t *self, int fd)
+{
+    char     buf[ACMATCH_CHUNK];
+    uint32_t state = 0;
+    int      best  = self->am_state[0].as_best;
+    int      last  = self->am_ids - 1;
+
+    while( best < last ) {
+        ssize_t rc = read(fd, buf, sizeof buf);
+
+        if( rc == -1 && errno == EINTR )
+            continue;
+
+        if( rc <= 0 )
+            break;
+
+        for( ssize_t i = 0; i < rc; ++i ) {
+            state = acmatch_step(self, state, (unsigned char)buf[i]);
+            if( best < self->am_state[state].as_best ) {
+                best = self->am_state[state].as_best;
+                if( best == last )
+                    break;
+            }
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,54 @@
+/** @file acmatch.h
+ *
+ * ssu-sysinfo - Multi-pattern substring matching
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  ACMATCH_H_
+# define ACMATCH_H_
+
+# include <stddef.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Aho-Corasick automaton for a set of patterns */
+typedef struct acmatch_t acmatch_t;
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+acmatch_t *acmatch_create  (void);
+void       acmatch_delete  (acmatch_t *self);
+int        acmatch_add     (acmatch_t *self, const char *pattern);
+void       acmatch_compile (acmatch_t *self);
+int        acmatch_scan_fd (const acmatch_t *self, int fd);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* ACMATCH_H_ */
@@ -0,0 +1,187 @@
+/** @file arena.c
+ *
+ * ssu-sysinfo - Bump pointer memory arena
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "arena.h"
+
+#include "xmalloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Size of the first chunk; subsequent chunks double in size */
+#define ARENA_CHUNK_MIN   4096
+
+/** Alignment used for arena_alloc() / arena_calloc() results */
+#define ARENA_ALIGN       (2 * sizeof(void *))
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+struct arena_chunk_t
+{
+    arena_chunk_t *ac_next;
+    size_t         ac_size;
+    char           ac_data[] __attribute__((aligned(ARENA_ALIGN)));
+};
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static void  arena_add_chunk (arena_t *self, size_t need);
+static void *arena_take      (arena_t *self, size_t size, size_t align);
+void         arena_ctor      (arena_t *self);
+void         arena_dtor      (arena_t *self);
+void         arena_reset     (arena_t *self);
+void        *arena_alloc     (arena_t *self, size_t size);
+void        *arena_calloc    (arena_t *self, size_t size);
+char        *arena_strdup    (arena_t *self, const char *str);
+
+/* ========================================================================= *
+ * Internal functions
+ * ========================================================================= */
+
+/** Start a new chunk that has room for at least need bytes
+ */
+static void
+arena_add_chunk(arena_t *self, size_t need)
+{
+    size_t size = self->ar_chunks ? self->ar_chunks->ac_size * 2 : ARENA_CHUNK_MIN;
+
+    while( size < need )
+        size *= 2;
+
+    arena_chunk_t *chunk = xmalloc(sizeof *chunk + size);
+    chunk->ac_next = self->ar_chunks;
+    chunk->ac_size = size;
+
+    self->ar_chunks = chunk;
+    self->ar_pos    = chunk->ac_data;
+    self->ar_end    = chunk->ac_data + size;
+}
+
+/** Carve size bytes with given alignment from the current chunk
+ */
+static void *
+arena_take(arena_t *self, size_t size, size_t align)
+{
+    size_t pad = -(size_t)self->ar_pos & (align - 1);
+
+    if( !self->ar_pos || (size_t)(self->ar_end - self->ar_pos) < pad + size ) {
+        arena_add_chunk(self, size);
+        pad = 0;
+    }
+
+    char *res = self->ar_pos + pad;
+    self->ar_pos = res + size;
+    return res;
+}
+
+/* ========================================================================= *
+ * External functions
+ * ========================================================================= */
+
+/** Initialize arena to empty state
+ */
+void
+arena_ctor(arena_t *self)
+{
+    self->ar_chunks = 0;
+    self->ar_pos    = 0;
+    self->ar_end    = 0;
+}
+
+/** Release all memory allocated from the arena
+ */
+void
+arena_dtor(arena_t *self)
+{
+    arena_chunk_t *chunk;
+
+    while( (chunk = self->ar_chunks) ) {
+        self->ar_chunks = chunk->ac_next;
+        free(chunk);
+    }
+    arena_ctor(self);
+}
+
+/** Invalidate all allocations, but keep memory for reuse
+ *
+ * If the arena had grown to multiple chunks, they are replaced
+ * with a single chunk large enough to hold the same amount of
+ * data, so that repeating a similar sequence of allocations does
+ * not need to touch the heap at all.
+ */
+void
+arena_reset(arena_t *self)
+{
+    arena_chunk_t *chunk = self->ar_chunks;
+
+    if( !chunk )
+        return;
+
+    if( chunk->ac_next ) {
+        size_t total = 0;
+        for( ; chunk; chunk = chunk->ac_next )
+            total += chunk->ac_size;
+        arena_dtor(self);
+        arena_add_chunk(self, total);
+    }
+    else {
+        self->ar_pos = chunk->ac_data;
+    }
+}
+
+/** Allocate uninitialized memory from arena
+ */
+void *
+arena_alloc(arena_t *self, size_t size)
+{
+    return arena_take(self, size, ARENA_ALIGN);
+}
+
+/** Allocate zero initialized memory from arena
+ */
+void *
+arena_calloc(arena_t *self, size_t size)
+{
+    return memset(arena_take(self, size, ARENA_ALIGN), 0, size);
+}
+
+/** Duplicate string to arena
+ *
+ * Like xstrdup(), tolerates null arguments.
+ */
+char *
+arena_strdup(arena_t *self, const char *str)
+{
+    char *res = 0;
+    if( str ) {
+        size_t size = strlen(str) + 1;
+        res = memcpy(arena_take(self, size, 1), str, size);
+    }
+    return res;
+}
@@ -0,0 +1,68 @@
+/** @file arena.h
+ *
+ * ssu-sysinfo - Bump pointer memory arena
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  ARENA_H_
+# define ARENA_H_
+
+# include <stddef.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+typedef struct arena_t       arena_t;
+typedef struct arena_chunk_t arena_chunk_t;
+
+/** Memory arena
+ *
+ * Objects are allocated by bumping a pointer within larger chunks
+ * and are never released individually. All memory is released in
+ * one go via arena_dtor(), or recycled via arena_reset().
+ */
+struct arena_t
+{
+    arena_chunk_t *ar_chunks; // most recently allocated chunk first
+    char          *ar_pos;    // next free byte in current chunk
+    char          *ar_end;    // end of current chunk
+};
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+void     arena_ctor    (arena_t *self);
+void     arena_dtor    (arena_t *self);
+void     arena_reset   (arena_t *self);
+void    *arena_alloc   (arena_t *self, size_t size);
+void    *arena_calloc  (arena_t *self, size_t size);
+char    *arena_strdup  (arena_t *self, const char *str);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* ARENA_H_ */
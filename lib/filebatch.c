@@ -0,0 +1,545 @@
+/** @file filebatch.c
+ *
+ * ssu-sysinfo - Reading sets of files in one go
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "filebatch.h"
+
+#include "util.h"
+#include "xmalloc.h"
+#include "logging.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined __has_include
+# if __has_include(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+# endif
+#endif
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/* Opening, stat'ing, reading and closing via io_uring needs linux 5.6
+ * or later; with older kernel headers only synchronous reading is
+ * available. Older kernels are dealt with at runtime. */
+#if defined IORING_FEAT_RW_CUR_POS && defined __NR_io_uring_setup && \
+    defined STATX_SIZE
+# define FILEBATCH_URING 1
+#else
+# define FILEBATCH_URING 0
+#endif
+
+#if FILEBATCH_URING
+
+/** Number of submission queue entries */
+# define FILEBATCH_RING_SIZE 64
+
+/** Number of files handled in one round, each needs up to two entries */
+# define FILEBATCH_CHUNK (FILEBATCH_RING_SIZE / 2)
+
+/** Setting up the ring costs about as much as reading a couple of files
+ *  synchronously, smaller batches are not worth it */
+# define FILEBATCH_URING_MIN 3
+
+/** Initial buffer size for files that do not report content size */
+# define FILEBATCH_PSEUDO_SIZE 4096
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Mapped io_uring submission and completion queues */
+typedef struct
+{
+    int                  rg_fd;
+
+    void                *rg_sq_ptr;
+    size_t               rg_sq_len;
+    void                *rg_cq_ptr;
+    size_t               rg_cq_len;
+    struct io_uring_sqe *rg_sqes;
+    size_t               rg_sqes_len;
+
+    unsigned            *rg_sq_tail;
+    unsigned            *rg_sq_mask;
+    unsigned            *rg_sq_array;
+    unsigned            *rg_cq_head;
+    unsigned            *rg_cq_tail;
+    unsigned            *rg_cq_mask;
+    struct io_uring_cqe *rg_cqes;
+
+    unsigned             rg_pending; // prepared, not yet submitted entries
+} filebatch_ring_t;
+
+/** Per file state while handling one chunk of files */
+typedef struct
+{
+    int          st_fd;
+    int          st_open_res;
+    int          st_stat_res;
+    int          st_read_res;
+    size_t       st_cap;
+    struct statx st_statx;
+} filebatch_state_t;
+
+#endif /* FILEBATCH_URING */
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+#if FILEBATCH_URING
+static bool                 filebatch_ring_open   (filebatch_ring_t *self);
+static void                 filebatch_ring_close  (filebatch_ring_t *self);
+static struct io_uring_sqe *filebatch_ring_sqe    (filebatch_ring_t *self, uint8_t opcode, int fd, uint64_t user_data);
+static bool                 filebatch_ring_submit (filebatch_ring_t *self, int *res);
+static bool                 filebatch_read_rest   (filebatch_t *file, int fd, size_t have, size_t cap);
+static bool                 filebatch_read_chunk  (filebatch_ring_t *ring, filebatch_t *files, size_t count, bool *sync);
+static void                 filebatch_read_uring  (filebatch_t *files, size_t count, bool *sync);
+#endif
+void                        filebatch_read        (filebatch_t *files, size_t count);
+
+#if FILEBATCH_URING
+/* ========================================================================= *
+ * io_uring
+ * ========================================================================= */
+
+/** Set up io_uring instance and map its queues
+ *
+ * @return true on success, or false if io_uring is not available
+ */
+static bool
+filebatch_ring_open(filebatch_ring_t *self)
+{
+    struct io_uring_params p = {};
+
+    memset(self, 0, sizeof *self);
+    self->rg_sq_ptr = self->rg_cq_ptr = self->rg_sqes = MAP_FAILED;
+
+    self->rg_fd = (int)syscall(__NR_io_uring_setup, FILEBATCH_RING_SIZE, &p);
+    if( self->rg_fd == -1 ) {
+        /* Kernel too old, or io_uring disabled by policy */
+        log_debug("io_uring_setup: %m");
+        goto FAIL;
+    }
+
+    self->rg_sq_len   = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    self->rg_cq_len   = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    self->rg_sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    if( p.features & IORING_FEAT_SINGLE_MMAP ) {
+        if( self->rg_sq_len < self->rg_cq_len )
+            self->rg_sq_len = self->rg_cq_len;
+        self->rg_cq_len = 0;
+    }
+
+    self->rg_sq_ptr = mmap(0, self->rg_sq_len, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, self->rg_fd,
+                           IORING_OFF_SQ_RING);
+    if( self->rg_sq_ptr == MAP_FAILED )
+        goto FAIL;
+
+    if( !self->rg_cq_len )
+        self->rg_cq_ptr = self->rg_sq_ptr;
+    else
+        self->rg_cq_ptr = mmap(0, self->rg_cq_len, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, self->rg_fd,
+                               IORING_OFF_CQ_RING);
+    if( self->rg_cq_ptr == MAP_FAILED )
+        goto FAIL;
+
+    self->rg_sqes = mmap(0, self->rg_sqes_len, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, self->rg_fd,
+                         IORING_OFF_SQES);
+    if( self->rg_sqes == MAP_FAILED )
+        goto FAIL;
+
+    char *sq = self->rg_sq_ptr;
+    char *cq = self->rg_cq_ptr;
+
+    self->rg_sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    self->rg_sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    self->rg_sq_array = (unsigned *)(sq + p.sq_off.array);
+    self->rg_cq_head  = (unsigned *)(cq + p.cq_off.head);
+    self->rg_cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    self->rg_cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    self->rg_cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    return true;
+
+FAIL:
+    if( self->rg_fd != -1 )
+        log_warning("io_uring mmap: %m");
+    filebatch_ring_close(self);
+    return false;
+}
+
+/** Unmap queues and close io_uring instance
+ */
+static void
+filebatch_ring_close(filebatch_ring_t *self)
+{
+    if( self->rg_sqes != MAP_FAILED )
+        munmap(self->rg_sqes, self->rg_sqes_len);
+
+    if( self->rg_cq_ptr != MAP_FAILED && self->rg_cq_ptr != self->rg_sq_ptr )
+        munmap(self->rg_cq_ptr, self->rg_cq_len);
+
+    if( self->rg_sq_ptr != MAP_FAILED )
+        munmap(self->rg_sq_ptr, self->rg_sq_len);
+
+    if( self->rg_fd != -1 )
+        close(self->rg_fd);
+
+    self->rg_sq_ptr = self->rg_cq_ptr = self->rg_sqes = MAP_FAILED;
+    self->rg_fd = -1;
+}
+
+/** Prepare submission queue entry
+ *
+ * Callers must not prepare more than FILEBATCH_RING_SIZE entries
+ * between filebatch_ring_submit() calls.
+ */
+static struct io_uring_sqe *
+filebatch_ring_sqe(filebatch_ring_t *self, uint8_t opcode, int fd,
+                   uint64_t user_data)
+{
+    unsigned tail = *self->rg_sq_tail + self->rg_pending++;
+    unsigned slot = tail & *self->rg_sq_mask;
+
+    struct io_uring_sqe *sqe = &self->rg_sqes[slot];
+    memset(sqe, 0, sizeof *sqe);
+    sqe->opcode    = opcode;
+    sqe->fd        = fd;
+    sqe->user_data = user_data;
+
+    self->rg_sq_array[slot] = slot;
+    return sqe;
+}
+
+/** Submit prepared entries and wait for all of them to complete
+ *
+ * On failure, results of entries that did complete are still stored,
+ * so that the caller can release resources such as opened files.
+ *
+ * @param res  array indexed by user_data, for storing results
+ *
+ * @return true on success, false if the ring is not usable
+ */
+static bool
+filebatch_ring_submit(filebatch_ring_t *self, int *res)
+{
+    bool     ack  = true;
+    unsigned todo = self->rg_pending;
+
+    self->rg_pending = 0;
+    __atomic_store_n(self->rg_sq_tail, *self->rg_sq_tail + todo,
+                     __ATOMIC_RELEASE);
+
+    unsigned submit = todo;
+
+    while( todo > 0 ) {
+        int rc = (int)syscall(__NR_io_uring_enter, self->rg_fd, submit, todo,
+                              IORING_ENTER_GETEVENTS, 0, 0);
+        if( rc == -1 ) {
+            if( errno == EINTR || errno == EAGAIN )
+                continue;
+            log_warning("io_uring_enter: %m");
+            ack = false;
+        }
+        else {
+            submit -= (unsigned)rc;
+        }
+
+        unsigned head = *self->rg_cq_head;
+        unsigned tail = __atomic_load_n(self->rg_cq_tail, __ATOMIC_ACQUIRE);
+
+        for( ; head != tail; ++head, --todo ) {
+            const struct io_uring_cqe *cqe =
+                &self->rg_cqes[head & *self->rg_cq_mask];
+            res[cqe->user_data] = cqe->res;
+        }
+
+        __atomic_store_n(self->rg_cq_head, head, __ATOMIC_RELEASE);
+
+        if( !ack )
+            break;
+    }
+
+    return ack;
+}
+
+/* ========================================================================= *
+ * Batch reading
+ * ========================================================================= */
+
+/** Synchronously read content that did not fit in the initial buffer
+ *
+ * @return true on success, false on failure
+ */
+static bool
+filebatch_read_rest(filebatch_t *file, int fd, size_t have, size_t cap)
+{
+    for( ;; ) {
+        if( have == cap )
+            file->fb_data = xrealloc(file->fb_data, (cap *= 2) + 1);
+
+        ssize_t rc = pread(fd, file->fb_data + have, cap - have, (off_t)have);
+        if( rc == -1 ) {
+            if( errno == EINTR )
+                continue;
+            log_warning("%s: read: %m", file->fb_path);
+            return false;
+        }
+        if( rc == 0 )
+            break;
+        have += (size_t)rc;
+    }
+
+    file->fb_data[have] = 0;
+    file->fb_size = have;
+    return true;
+}
+
+/** Read up to FILEBATCH_CHUNK files using three io_uring submissions
+ *
+ * Files that can't be handled via io_uring for any other reason than
+ * not existing are flagged to be read synchronously instead - also
+ * when the ring fails, in which case any files opened are closed.
+ *
+ * @param sync  array of flags for files that need to be read synchronously
+ *
+ * @return true on success, false if the ring is not usable
+ */
+static bool
+filebatch_read_chunk(filebatch_ring_t *ring, filebatch_t *files,
+                     size_t count, bool *sync)
+{
+    filebatch_state_t st[FILEBATCH_CHUNK];
+    int               res[FILEBATCH_CHUNK * 2];
+
+    /* Open and stat all files */
+    for( size_t i = 0; i < count; ++i ) {
+        st[i].st_fd       = -1;
+        st[i].st_open_res = -ECANCELED;
+        st[i].st_stat_res = -ECANCELED;
+        st[i].st_read_res = -ECANCELED;
+
+        if( !files[i].fb_path )
+            continue;
+
+        struct io_uring_sqe *sqe;
+
+        sqe = filebatch_ring_sqe(ring, IORING_OP_OPENAT, AT_FDCWD, 2 * i);
+        sqe->addr       = (uintptr_t)files[i].fb_path;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+
+        sqe = filebatch_ring_sqe(ring, IORING_OP_STATX, AT_FDCWD, 2 * i + 1);
+        sqe->addr = (uintptr_t)files[i].fb_path;
+        sqe->len  = STATX_SIZE;
+        sqe->off  = (uintptr_t)&st[i].st_statx;
+    }
+
+    for( size_t i = 0; i < 2 * count; ++i )
+        res[i] = -ECANCELED;
+
+    if( !filebatch_ring_submit(ring, res) ) {
+        for( size_t i = 0; i < count; ++i ) {
+            if( !files[i].fb_path )
+                continue;
+            if( res[2 * i] >= 0 )
+                close(res[2 * i]);
+            sync[i] = true;
+        }
+        return false;
+    }
+
+    /* Read opened files, sized according to statx results */
+    for( size_t i = 0; i < count; ++i ) {
+        st[i].st_open_res = res[2 * i];
+        st[i].st_stat_res = res[2 * i + 1];
+
+        if( !files[i].fb_path )
+            continue;
+
+        if( st[i].st_open_res < 0 ) {
+            if( st[i].st_open_res == -ENOENT )
+                log_debug("%s: open: %s", files[i].fb_path,
+                          strerror(ENOENT));
+            else
+                sync[i] = true;
+            continue;
+        }
+
+        st[i].st_fd = st[i].st_open_res;
+
+        /* Ask for one byte more than expected, to detect growing files.
+         * Pseudo files report zero size, but can have content. */
+        size_t size = 0;
+        if( st[i].st_stat_res == 0 )
+            size = (size_t)st[i].st_statx.stx_size;
+        st[i].st_cap = size ? size + 1 : FILEBATCH_PSEUDO_SIZE;
+
+        files[i].fb_data = xmalloc(st[i].st_cap + 1);
+
+        struct io_uring_sqe *sqe =
+            filebatch_ring_sqe(ring, IORING_OP_READ, st[i].st_fd, i);
+        sqe->addr = (uintptr_t)files[i].fb_data;
+        sqe->len  = (unsigned)st[i].st_cap;
+        sqe->off  = 0;
+    }
+
+    for( size_t i = 0; i < count; ++i )
+        res[i] = -ECANCELED;
+
+    bool ack = filebatch_ring_submit(ring, res);
+
+    /* Finish reading, then close all opened files */
+    for( size_t i = 0; i < count; ++i ) {
+        if( st[i].st_fd == -1 )
+            continue;
+
+        st[i].st_read_res = ack ? res[i] : -ECANCELED;
+
+        bool done = false;
+        if( st[i].st_read_res >= 0 ) {
+            size_t have = (size_t)st[i].st_read_res;
+            if( have < st[i].st_cap ) {
+                files[i].fb_data[have] = 0;
+                files[i].fb_size = have;
+                done = true;
+            }
+            else {
+                done = filebatch_read_rest(&files[i], st[i].st_fd,
+                                           have, st[i].st_cap);
+            }
+        }
+
+        if( !done ) {
+            free(files[i].fb_data), files[i].fb_data = 0;
+            files[i].fb_size = 0;
+            sync[i] = true;
+        }
+
+        if( ack )
+            filebatch_ring_sqe(ring, IORING_OP_CLOSE, st[i].st_fd, i);
+    }
+
+    bool closing = ack;
+
+    if( closing ) {
+        for( size_t i = 0; i < count; ++i )
+            res[i] = -ECANCELED;
+
+        ack = filebatch_ring_submit(ring, res);
+    }
+
+    /* Kernels that do not support closing via io_uring, and files that
+     * were not closed before the ring failed. Files that did get closed
+     * must not be closed again, the descriptor might be in use already. */
+    for( size_t i = 0; i < count; ++i ) {
+        if( st[i].st_fd != -1 && (!closing || res[i] < 0) )
+            close(st[i].st_fd);
+    }
+
+    return ack;
+}
+
+/** Read files via io_uring
+ *
+ * @param sync  array of flags for files that need to be read synchronously
+ */
+static void
+filebatch_read_uring(filebatch_t *files, size_t count, bool *sync)
+{
+    filebatch_ring_t ring;
+
+    if( count < FILEBATCH_URING_MIN || !filebatch_ring_open(&ring) ) {
+        for( size_t i = 0; i < count; ++i )
+            sync[i] = true;
+        return;
+    }
+
+    for( size_t i = 0; i < count; i += FILEBATCH_CHUNK ) {
+        size_t n = count - i;
+        if( n > FILEBATCH_CHUNK )
+            n = FILEBATCH_CHUNK;
+
+        if( !filebatch_read_chunk(&ring, files + i, n, sync + i) ) {
+            /* Leave the rest for synchronous reading */
+            for( size_t j = i + n; j < count; ++j )
+                sync[j] = true;
+            break;
+        }
+    }
+
+    filebatch_ring_close(&ring);
+}
+#endif /* FILEBATCH_URING */
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+/** Read content of a set of files
+ *
+ * When available, io_uring is used for opening, reading and closing
+ * all the files with just a few system calls. Otherwise, and for files
+ * that can't be handled via io_uring, files are read one by one.
+ *
+ * @param files  array of files to read
+ * @param count  number of files
+ */
+void
+filebatch_read(filebatch_t *files, size_t count)
+{
+    bool *sync = xcalloc(count ?: 1, sizeof *sync);
+
+    for( size_t i = 0; i < count; ++i ) {
+        files[i].fb_data = 0;
+        files[i].fb_size = 0;
+    }
+
+#if FILEBATCH_URING
+    filebatch_read_uring(files, count, sync);
+#else
+    for( size_t i = 0; i < count; ++i )
+        sync[i] = true;
+#endif
+
+    for( size_t i = 0; i < count; ++i ) {
+        if( sync[i] && files[i].fb_path )
+            files[i].fb_data = fileutil_read(files[i].fb_path,
+                                             &files[i].fb_size);
+    }
+
+    free(sync);
+}
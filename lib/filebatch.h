@@ -0,0 +1,56 @@
+/** @file filebatch.h
+ *
+ * ssu-sysinfo - Reading sets of files in one go
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  FILEBATCH_H_
+# define FILEBATCH_H_
+
+# include <stddef.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** File to read as a part of a batch */
+typedef struct
+{
+    const char *fb_path; // file to read, or NULL to skip the entry
+    char       *fb_data; // NUL terminated content to be released via free(),
+                         // or NULL if the file could not be read
+    size_t      fb_size; // content size
+} filebatch_t;
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+void filebatch_read(filebatch_t *files, size_t count);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* FILEBATCH_H_ */
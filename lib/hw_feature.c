@@ -23,163 +23,140 @@
 
 #include "hw_feature.h"
 
+#include "namehash.h"
 #include "xmalloc.h"
 
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
-/** Key names used in CSD data files.
+/* Feature sets are represented as 64-bit masks */
+_Static_assert(Feature_Count <= 64, "hw_feature_t does not fit in mask");
+
+/** Feature names as relocation free string pool
  *
- * @note: Used only for CSD data lookups - must not be exposed by
- *        the library API.
+ * Each name is a separate member, so that offsets to names can be
+ * resolved at compile time.
+ */
+typedef struct
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) char ID[sizeof #ID];
+#include "hw_feature.def"
+#undef HW_FEATURE
+} hw_feature_name_pool_t;
+
+static const hw_feature_name_pool_t hw_feature_name_pool =
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) #ID,
+#include "hw_feature.def"
+#undef HW_FEATURE
+};
+
+/** Key names used in CSD data files as relocation free string pool
+ */
+typedef struct
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) char CSD[sizeof #CSD];
+#include "hw_feature.def"
+#undef HW_FEATURE
+} hw_feature_csd_pool_t;
+
+static const hw_feature_csd_pool_t hw_feature_csd_pool =
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) #CSD,
+#include "hw_feature.def"
+#undef HW_FEATURE
+};
+
+_Static_assert(sizeof hw_feature_name_pool <= UINT16_MAX &&
+               sizeof hw_feature_csd_pool <= UINT16_MAX,
+               "hw_feature pools do not fit in 16-bit offsets");
+
+/** Offsets of key names used by ssu-sysinfo in hw_feature_name_pool
  */
-static const char * const hw_feature_csd_key_lut[Feature_Count] =
-{
-    [Feature_Invalid]               = "Invalid",
-    [Feature_Microphone1]           = "AudioMic1",
-    [Feature_Microphone2]           = "AudioMic2",
-    [Feature_BackCamera]            = "BackCamera",
-    [Feature_BackCameraFlashlight]  = "BackCameraFlash",
-    [Feature_DisplayBacklight]      = "Backlight",
-    [Feature_Battery]               = "Battery",
-    [Feature_Bluetooth]             = "Bluetooth",
-    [Feature_CellularData]          = "CellularData",
-    [Feature_CellularVoice]         = "CellularVoice",
-    [Feature_CompassSensor]         = "ECompass",
-    [Feature_FMRadioReceiver]       = "FmRadio",
-    [Feature_FrontCamera]           = "FrontCamera",
-    [Feature_FrontCameraFlashlight] = "FrontCameraFlash",
-    [Feature_GPS]                   = "GPS",
-    [Feature_CellInfo]              = "CellInfo",
-    [Feature_AccelerationSensor]    = "GSensor",
-    [Feature_GyroSensor]            = "Gyro",
-    [Feature_CoverSensor]           = "Hall",
-    [Feature_FingerprintSensor]     = "Fingerprint",
-    [Feature_Headset]               = "Headset",
-    [Feature_HardwareKeys]          = "Key",
-    [Feature_Display]               = "LCD",
-    [Feature_NotificationLED]       = "LED",
-    [Feature_ButtonBacklight]       = "ButtonBacklight",
-    [Feature_LightSensor]           = "LightSensor",
-    [Feature_Loudspeaker]           = "Loudspeaker",
-    [Feature_TheOtherHalf]          = "TOH",
-    [Feature_ProximitySensor]       = "ProxSensor",
-    [Feature_AudioPlayback]         = "Receiver",
-    [Feature_MemoryCardSlot]        = "SDCard",
-    [Feature_SIMCardSlot]           = "SIM",
-    [Feature_StereoLoudspeaker]     = "StereoLoudspeaker",
-    [Feature_TouchScreen]           = "Touch",
-    [Feature_TouchScreenSelfTest]   = "TouchAuto",
-    [Feature_USBCharging]           = "UsbCharging",
-    [Feature_USBOTG]                = "UsbOtg",
-    [Feature_Vibrator]              = "Vibrator",
-    [Feature_WLAN]                  = "Wifi",
-    [Feature_NFC]                   = "NFC",
-    [Feature_VideoPlayback]         = "VideoPlayback",
-    [Feature_Suspend]               = "Suspend",
-    [Feature_Reboot]                = "Reboot",
-    [Feature_BluetoothTethering]    = "BluetoothTethering",
+static const uint16_t hw_feature_name_lut[Feature_Count] =
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) [ID] = offsetof(hw_feature_name_pool_t, ID),
+#include "hw_feature.def"
+#undef HW_FEATURE
 };
 
-/** Key names used by ssu-sysinfo
+/** Offsets of CSD key names in hw_feature_csd_pool
  */
-static const char * const hw_feature_name_lut[Feature_Count] =
-{
-    [Feature_Invalid]               = "Feature_Invalid",
-    [Feature_Microphone1]           = "Feature_Microphone1",
-    [Feature_Microphone2]           = "Feature_Microphone2",
-    [Feature_BackCamera]            = "Feature_BackCamera",
-    [Feature_BackCameraFlashlight]  = "Feature_BackCameraFlashlight",
-    [Feature_DisplayBacklight]      = "Feature_DisplayBacklight",
-    [Feature_Battery]               = "Feature_Battery",
-    [Feature_Bluetooth]             = "Feature_Bluetooth",
-    [Feature_CellularData]          = "Feature_CellularData",
-    [Feature_CellularVoice]         = "Feature_CellularVoice",
-    [Feature_CompassSensor]         = "Feature_CompassSensor",
-    [Feature_FMRadioReceiver]       = "Feature_FMRadioReceiver",
-    [Feature_FrontCamera]           = "Feature_FrontCamera",
-    [Feature_FrontCameraFlashlight] = "Feature_FrontCameraFlashlight",
-    [Feature_GPS]                   = "Feature_GPS",
-    [Feature_CellInfo]              = "Feature_CellInfo",
-    [Feature_AccelerationSensor]    = "Feature_AccelerationSensor",
-    [Feature_GyroSensor]            = "Feature_GyroSensor",
-    [Feature_CoverSensor]           = "Feature_CoverSensor",
-    [Feature_FingerprintSensor]     = "Feature_FingerprintSensor",
-    [Feature_Headset]               = "Feature_Headset",
-    [Feature_HardwareKeys]          = "Feature_HardwareKeys",
-    [Feature_Display]               = "Feature_Display",
-    [Feature_NotificationLED]       = "Feature_NotificationLED",
-    [Feature_ButtonBacklight]       = "Feature_ButtonBacklight",
-    [Feature_LightSensor]           = "Feature_LightSensor",
-    [Feature_Loudspeaker]           = "Feature_Loudspeaker",
-    [Feature_TheOtherHalf]          = "Feature_TheOtherHalf",
-    [Feature_ProximitySensor]       = "Feature_ProximitySensor",
-    [Feature_AudioPlayback]         = "Feature_AudioPlayback",
-    [Feature_MemoryCardSlot]        = "Feature_MemoryCardSlot",
-    [Feature_SIMCardSlot]           = "Feature_SIMCardSlot",
-    [Feature_StereoLoudspeaker]     = "Feature_StereoLoudspeaker",
-    [Feature_TouchScreen]           = "Feature_TouchScreen",
-    [Feature_TouchScreenSelfTest]   = "Feature_TouchScreenSelfTest",
-    [Feature_USBCharging]           = "Feature_USBCharging",
-    [Feature_USBOTG]                = "Feature_USBOTG",
-    [Feature_Vibrator]              = "Feature_Vibrator",
-    [Feature_WLAN]                  = "Feature_WLAN",
-    [Feature_NFC]                   = "Feature_NFC",
-    [Feature_VideoPlayback]         = "Feature_VideoPlayback",
-    [Feature_Suspend]               = "Feature_Suspend",
-    [Feature_Reboot]                = "Feature_Reboot",
-    [Feature_BluetoothTethering]    = "Feature_BluetoothTethering",
+static const uint16_t hw_feature_csd_key_lut[Feature_Count] =
+{
+#define HW_FEATURE(ID, CSD, FALLBACK) [ID] = offsetof(hw_feature_csd_pool_t, CSD),
+#include "hw_feature.def"
+#undef HW_FEATURE
 };
 
 /* Feature availability to use when CSD config line is missing
  */
 static const bool hw_feature_fallback_lut[Feature_Count] =
 {
-    [Feature_Invalid]               = false,
-    [Feature_Microphone1]           = false,
-    [Feature_Microphone2]           = false,
-    [Feature_BackCamera]            = false,
-    [Feature_BackCameraFlashlight]  = false,
-    [Feature_DisplayBacklight]      = false,
-    [Feature_Battery]               = false,
-    [Feature_Bluetooth]             = false,
-    [Feature_CellularData]          = false,
-    [Feature_CellularVoice]         = false,
-    [Feature_CompassSensor]         = false,
-    [Feature_FMRadioReceiver]       = false,
-    [Feature_FrontCamera]           = false,
-    [Feature_FrontCameraFlashlight] = false,
-    [Feature_GPS]                   = false,
-    [Feature_CellInfo]              = false,
-    [Feature_AccelerationSensor]    = false,
-    [Feature_GyroSensor]            = false,
-    [Feature_CoverSensor]           = false,
-    [Feature_FingerprintSensor]     = false,
-    [Feature_Headset]               = false,
-    [Feature_HardwareKeys]          = false,
-    [Feature_Display]               = false,
-    [Feature_NotificationLED]       = false,
-    [Feature_ButtonBacklight]       = false,
-    [Feature_LightSensor]           = false,
-    [Feature_Loudspeaker]           = false,
-    [Feature_TheOtherHalf]          = false,
-    [Feature_ProximitySensor]       = false,
-    [Feature_AudioPlayback]         = false,
-    [Feature_MemoryCardSlot]        = false,
-    [Feature_SIMCardSlot]           = false,
-    [Feature_StereoLoudspeaker]     = false,
-    [Feature_TouchScreen]           = false,
-    [Feature_TouchScreenSelfTest]   = false,
-    [Feature_USBCharging]           = false,
-    [Feature_USBOTG]                = false,
-    [Feature_Vibrator]              = false,
-    [Feature_WLAN]                  = false,
-    [Feature_NFC]                   = false,
-    [Feature_VideoPlayback]         = false,
-    [Feature_Suspend]               = true,
-    [Feature_Reboot]                = true,
-    [Feature_BluetoothTethering]    = false,
+#define HW_FEATURE(ID, CSD, FALLBACK) [ID] = FALLBACK,
+#include "hw_feature.def"
+#undef HW_FEATURE
 };
 
+/** Get ssu-sysinfo name of a feature
+ */
+static const char *
+hw_feature_name(hw_feature_t id)
+{
+    return (const char *)&hw_feature_name_pool + hw_feature_name_lut[id];
+}
+
+/** Get CSD key name of a feature
+ */
+static const char *
+hw_feature_csd_key(hw_feature_t id)
+{
+    return (const char *)&hw_feature_csd_pool + hw_feature_csd_key_lut[id];
+}
+
+/* Perfect hash of feature names, generated at build time */
+#include "hw_feature_hash.h"
+
+_Static_assert(HW_FEATURE_HASH_COUNT == Feature_Count,
+               "hw_feature_hash.h is out of sync with hw_feature.def");
+
+/** Feature ids sorted by CSD key, for reverse lookups */
+static hw_feature_t   hw_feature_csd_index[Feature_Count];
+static size_t         hw_feature_csd_index_len  = 0;
+static pthread_once_t hw_feature_csd_index_once = PTHREAD_ONCE_INIT;
+
+static int
+hw_feature_csd_index_sort_cb(const void *a, const void *b)
+{
+    const hw_feature_t *id1 = a;
+    const hw_feature_t *id2 = b;
+    return strcmp(hw_feature_csd_key(*id1), hw_feature_csd_key(*id2));
+}
+
+static int
+hw_feature_csd_index_find_cb(const void *a, const void *b)
+{
+    const char         *key = a;
+    const hw_feature_t *id  = b;
+    return strcmp(key, hw_feature_csd_key(*id));
+}
+
+static void
+hw_feature_csd_index_init(void)
+{
+    size_t used = 0;
+
+    for( hw_feature_t id = Feature_Invalid + 1; id < Feature_Count; ++id )
+        hw_feature_csd_index[used++] = id;
+
+    qsort(hw_feature_csd_index, used, sizeof *hw_feature_csd_index,
+          hw_feature_csd_index_sort_cb);
+
+    hw_feature_csd_index_len = used;
+}
+
 bool
 hw_feature_is_valid(hw_feature_t id)
 {
@@ -198,7 +175,7 @@ hw_feature_to_string(hw_feature_t id)
     if( !hw_feature_is_valid(id) )
         id = Feature_Invalid;
 
-    return hw_feature_name_lut[id];
+    return hw_feature_name(id);
 }
 
 hw_feature_t
@@ -209,12 +186,10 @@ hw_feature_from_string(const char *name)
     if( !name )
         goto EXIT;
 
-    for( hw_feature_t i = 0; i < Feature_Count; ++i ) {
-        if( !strcasecmp(hw_feature_name_lut[i], name) ) {
-            res = i;
-            break;
-        }
-    }
+    hw_feature_t i = namehash_lookup(&hw_feature_hash, name);
+
+    if( !strcasecmp(hw_feature_name(i), name) )
+        res = i;
 
 EXIT:
     return res;
@@ -226,19 +201,75 @@ hw_feature_to_csd_key(hw_feature_t id)
     if( !hw_feature_is_valid(id) )
         id = Feature_Invalid;
 
-    return hw_feature_csd_key_lut[id];
+    return hw_feature_csd_key(id);
+}
+
+hw_feature_t
+hw_feature_from_csd_key(const char *key)
+{
+    hw_feature_t *hit = 0;
+
+    if( !key )
+        goto EXIT;
+
+    pthread_once(&hw_feature_csd_index_once, hw_feature_csd_index_init);
+
+    hit = bsearch(key, hw_feature_csd_index, hw_feature_csd_index_len,
+                  sizeof *hw_feature_csd_index, hw_feature_csd_index_find_cb);
+
+EXIT:
+    return hit ? *hit : Feature_Invalid;
+}
+
+uint64_t
+hw_feature_fallback_mask(void)
+{
+    uint64_t mask = 0;
+
+    for( hw_feature_t id = Feature_Invalid + 1; id < Feature_Count; ++id ) {
+        if( hw_feature_fallback_lut[id] )
+            mask |= UINT64_C(1) << id;
+    }
+
+    return mask;
+}
+
+/** NULL terminated array of feature names, excluding Feature_Invalid
+ *
+ * Filled in on first use to avoid load time relocations.
+ */
+static const char    *hw_feature_name_array[Feature_Count];
+static pthread_once_t hw_feature_name_array_once = PTHREAD_ONCE_INIT;
+
+static void
+hw_feature_name_array_init(void)
+{
+    size_t k = 0;
+
+    for( hw_feature_t id = Feature_Invalid + 1; id < Feature_Count; ++id )
+        hw_feature_name_array[k++] = hw_feature_name(id);
+}
+
+const char * const *
+hw_feature_name_list(void)
+{
+    pthread_once(&hw_feature_name_array_once, hw_feature_name_array_init);
+    return hw_feature_name_array;
+}
+
+size_t
+hw_feature_name_count(void)
+{
+    return Feature_Count - 1;
 }
 
 const char **
 hw_feature_names(void)
 {
-    size_t       n = Feature_Count;
-    const char **v = xcalloc(n, sizeof *v);
-    size_t       k = 0;
+    size_t       n = hw_feature_name_count();
+    const char **v = xmalloc((n + 1) * sizeof *v);
 
-    for( size_t i = Feature_Invalid + 1; i < n; ++i )
-        v[k++] = hw_feature_name_lut[i];
-    v[k] = 0;
+    memcpy(v, hw_feature_name_list(), (n + 1) * sizeof *v);
 
     return v;
 }
@@ -35,7 +35,11 @@ bool          hw_feature_get_fallback (hw_feature_t id);
 const char   *hw_feature_to_string    (hw_feature_t id);
 hw_feature_t  hw_feature_from_string  (const char *name);
 const char   *hw_feature_to_csd_key   (hw_feature_t id);
+hw_feature_t  hw_feature_from_csd_key (const char *key);
+uint64_t      hw_feature_fallback_mask(void);
 const char  **hw_feature_names        (void);
+const char * const *hw_feature_name_list(void);
+size_t        hw_feature_name_count   (void);
 
 # ifdef __cplusplus
 };
@@ -0,0 +1,26 @@
+/* Generated by util/namehash-gen - do not edit */
+
+#define HW_FEATURE_HASH_COUNT 44
+
+static const uint16_t hw_feature_hash_disp[15] =
+{
+    12, 2, 0, 6, 7, 1, 2, 2, 0, 22, 1, 0,
+    28, 105, 151,
+};
+
+static const uint16_t hw_feature_hash_slot[44] =
+{
+    19, 16, 24, 39, 21, 22, 1, 26, 30, 0, 34, 28,
+    25, 31, 14, 13, 8, 36, 6, 10, 32, 27, 20, 9,
+    11, 23, 7, 17, 3, 40, 37, 43, 41, 42, 35, 33,
+    2, 12, 29, 18, 4, 38, 15, 5,
+};
+
+static const namehash_t hw_feature_hash =
+{
+    .nh_seed    = 0x00000001,
+    .nh_buckets = 15,
+    .nh_count   = 44,
+    .nh_disp    = hw_feature_hash_disp,
+    .nh_slot    = hw_feature_hash_slot,
+};
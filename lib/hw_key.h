@@ -26,16 +26,39 @@
 
 # include "ssusysinfo.h"
 
+# include <stddef.h>
+
 # ifdef __cplusplus
 extern "C" {
 # endif
 
+/** Set of key codes parsed from configuration
+ *
+ * Codes that fit in a byte are kept in a bitmap, the rest - mostly
+ * Qt special keys in the 0x01xxxxxx range - in a sorted array without
+ * duplicates.
+ */
+typedef struct
+{
+    uint64_t  ks_bits[4];  // codes 0x00 ... 0xff
+    hw_key_t *ks_more;     // codes above 0xff, sorted, or NULL
+    size_t    ks_count;    // number of codes in ks_more
+} hw_key_set_t;
+
 hw_key_t     hw_key_from_string (const char *name);
 const char  *hw_key_to_string   (hw_key_t code);
 const char **hw_key_names       (void);
+const char * const *hw_key_name_list(void);
+size_t       hw_key_name_count  (void);
 bool         hw_key_is_valid    (hw_key_t code);
 hw_key_t    *hw_key_parse_array (const char *text);
 
+void         hw_key_set_init    (hw_key_set_t *self);
+void         hw_key_set_clear   (hw_key_set_t *self);
+void         hw_key_set_parse   (hw_key_set_t *self, const char *text);
+bool         hw_key_set_has     (const hw_key_set_t *self, hw_key_t code);
+hw_key_t    *hw_key_set_array   (const hw_key_set_t *self);
+
 # ifdef __cplusplus
 };
 # endif
@@ -0,0 +1,68 @@
+/* Generated by util/namehash-gen - do not edit */
+
+#define HW_KEY_HASH_COUNT 421
+
+static const uint16_t hw_key_hash_disp[141] =
+{
+    26, 0, 9, 24, 0, 4, 2, 2, 30, 13, 30, 2,
+    0, 31, 12, 52, 8, 2, 2, 1, 2, 43, 3, 10,
+    23, 18, 0, 8, 4, 2, 2, 16, 31, 10, 0, 13,
+    14, 16, 4, 72, 1, 11, 0, 60, 4, 61, 67, 8,
+    11, 4, 3, 0, 39, 9, 36, 7, 2, 30, 16, 41,
+    1, 1, 5, 16, 6, 0, 22, 40, 0, 0, 26, 0,
+    5, 71, 4, 8, 0, 15, 42, 2, 128, 18, 108, 53,
+    39, 152, 3, 58, 21, 2, 0, 73, 44, 0, 2, 137,
+    56, 68, 80, 24, 278, 6, 29, 20, 28, 145, 4, 15,
+    8, 1, 0, 30, 2, 44, 9, 14, 1, 1, 4, 13,
+    211, 142, 0, 76, 6, 201, 247, 4, 14, 660, 0, 10,
+    8, 356, 279, 3, 27, 66, 4, 2, 219,
+};
+
+static const uint16_t hw_key_hash_slot[421] =
+{
+    44, 234, 69, 11, 339, 383, 61, 226, 377, 212, 214, 183,
+    385, 8, 298, 228, 211, 32, 72, 142, 223, 342, 1, 215,
+    7, 148, 284, 365, 219, 75, 210, 376, 172, 236, 65, 357,
+    193, 121, 329, 278, 21, 130, 410, 94, 263, 378, 199, 188,
+    200, 268, 190, 198, 15, 353, 294, 208, 231, 166, 62, 332,
+    403, 89, 122, 51, 27, 206, 53, 394, 163, 392, 386, 46,
+    209, 320, 366, 36, 134, 3, 84, 240, 347, 164, 321, 47,
+    414, 318, 326, 246, 97, 265, 136, 137, 98, 324, 49, 91,
+    398, 83, 322, 110, 155, 35, 38, 169, 258, 409, 257, 311,
+    161, 218, 250, 76, 109, 370, 331, 241, 274, 328, 14, 149,
+    25, 191, 337, 299, 300, 106, 368, 407, 372, 105, 232, 112,
+    63, 28, 277, 82, 406, 54, 178, 375, 296, 196, 34, 58,
+    391, 238, 374, 93, 13, 37, 40, 224, 45, 184, 338, 361,
+    23, 123, 88, 302, 100, 279, 343, 151, 174, 327, 344, 309,
+    341, 235, 286, 86, 177, 143, 107, 162, 96, 126, 389, 10,
+    70, 168, 316, 304, 101, 118, 179, 259, 138, 247, 269, 230,
+    147, 292, 127, 18, 50, 363, 99, 359, 220, 132, 33, 66,
+    56, 395, 252, 216, 52, 77, 379, 153, 146, 81, 373, 59,
+    387, 157, 267, 187, 233, 80, 350, 186, 264, 95, 192, 165,
+    237, 79, 104, 133, 262, 135, 129, 111, 213, 312, 402, 275,
+    358, 404, 271, 158, 412, 9, 67, 369, 371, 380, 245, 288,
+    354, 396, 351, 399, 305, 182, 16, 345, 17, 303, 156, 335,
+    41, 225, 346, 173, 306, 254, 317, 261, 356, 413, 248, 319,
+    113, 131, 140, 285, 227, 272, 197, 287, 48, 85, 171, 108,
+    30, 202, 239, 12, 154, 55, 243, 330, 360, 293, 325, 297,
+    189, 26, 253, 119, 43, 384, 418, 115, 381, 71, 280, 60,
+    256, 323, 4, 336, 139, 307, 340, 313, 141, 20, 393, 411,
+    416, 315, 24, 180, 308, 117, 242, 144, 176, 405, 400, 282,
+    221, 289, 382, 401, 125, 160, 87, 90, 362, 415, 5, 194,
+    152, 92, 355, 22, 348, 145, 68, 181, 78, 255, 291, 364,
+    103, 6, 195, 29, 295, 185, 120, 114, 260, 150, 203, 229,
+    270, 281, 116, 201, 276, 251, 175, 408, 57, 0, 102, 349,
+    334, 249, 266, 273, 124, 217, 397, 204, 333, 73, 170, 39,
+    310, 301, 19, 31, 244, 388, 167, 352, 74, 222, 207, 205,
+    314, 419, 128, 417, 42, 283, 64, 390, 367, 2, 420, 290,
+    159,
+};
+
+static const namehash_t hw_key_hash =
+{
+    .nh_seed    = 0x00000001,
+    .nh_buckets = 141,
+    .nh_count   = 421,
+    .nh_disp    = hw_key_hash_disp,
+    .nh_slot    = hw_key_hash_slot,
+};
@@ -0,0 +1,671 @@
+/** @file inidb.c
+ *
+ * ssu-sysinfo - Compiled ini file database
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "inidb.h"
+
+#include "xmalloc.h"
+#include "logging.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <libgen.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** File identification */
+#define INIDB_MAGIC    "SSUINIDB"
+
+/** Bumped whenever file layout changes */
+#define INIDB_VERSION  2
+
+/** Stored as-is, used for detecting files written with other byte order */
+#define INIDB_ENDIAN   0x01020304u
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** File header
+ *
+ * All offsets are relative to start of file, string references are
+ * offsets relative to start of the string pool.
+ */
+typedef struct
+{
+    char      dh_magic[8];
+    uint32_t  dh_version;
+    uint32_t  dh_endian;
+    uint32_t  dh_size;       // total file size
+    uint32_t  dh_max_ord;    // largest ordinal used in values
+
+    uint32_t  dh_src_offs;   // inidb_src_t array
+    uint32_t  dh_src_count;
+    uint32_t  dh_sec_offs;   // inidb_sec_t array, sorted by name
+    uint32_t  dh_sec_count;
+    uint32_t  dh_val_offs;   // inidb_val_t array, grouped by section
+    uint32_t  dh_val_count;
+    uint32_t  dh_str_offs;   // NUL terminated strings
+    uint32_t  dh_str_size;
+} inidb_head_t;
+
+/** Source file stamp
+ *
+ * Missing files are recorded with ds_size set to -1.
+ */
+typedef struct
+{
+    uint32_t  ds_path;
+    uint32_t  ds_pad;
+    uint64_t  ds_ino;
+    int64_t   ds_size;
+    int64_t   ds_mtime_sec;
+    int64_t   ds_mtime_nsec;
+} inidb_src_t;
+
+/** Section */
+typedef struct
+{
+    uint32_t  ds_name;
+    uint32_t  ds_first;      // index of first value
+    uint32_t  ds_count;      // number of values
+} inidb_sec_t;
+
+/** Key-value entry */
+typedef struct
+{
+    uint32_t  dv_key;
+    uint32_t  dv_val;
+    int32_t   dv_ord;
+} inidb_val_t;
+
+/** Read only view to a compiled ini database file
+ *
+ * The database holds merged content of a set of ini files, with
+ * sections sorted by name and values within sections sorted by key.
+ * All references within the file are offsets, so the file can be
+ * used directly from a read only mapping without any fixups.
+ *
+ * In addition to the content, path, inode, size and modification time
+ * of each source file are stored, so that it is possible to detect
+ * when the database needs to be regenerated. Directories can be
+ * stamped too, which makes it possible to detect added and removed
+ * files, and so can files that do not exist.
+ */
+struct inidb_t
+{
+    unsigned            db_refs;
+
+    const char         *db_data;
+    size_t              db_size;
+
+    const inidb_head_t *db_head;
+    const inidb_src_t  *db_src;
+    const inidb_sec_t  *db_sec;
+    const inidb_val_t  *db_val;
+    const char         *db_str;
+};
+
+/** Dynamic buffer used while compiling */
+typedef struct
+{
+    char   *ob_data;
+    size_t  ob_size;
+    size_t  ob_alloc;
+} inidb_buf_t;
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static bool        inidb_span_ok      (size_t size, uint32_t offs, uint32_t count, size_t elem, size_t align);
+static const char *inidb_str          (const inidb_t *self, uint32_t offs);
+inidb_t           *inidb_open         (const char *path);
+inidb_t           *inidb_ref          (inidb_t *self);
+void               inidb_close        (inidb_t *self);
+bool               inidb_is_current   (const inidb_t *self);
+size_t             inidb_source_count (const inidb_t *self);
+const char        *inidb_source_path  (const inidb_t *self, size_t ind);
+int                inidb_max_ord      (const inidb_t *self);
+size_t             inidb_section_count(const inidb_t *self);
+const char        *inidb_section_name (const inidb_t *self, size_t sec);
+bool               inidb_find_section (const inidb_t *self, const char *name, size_t *psec);
+size_t             inidb_value_count  (const inidb_t *self, size_t sec);
+bool               inidb_value        (const inidb_t *self, size_t sec, size_t ind, const char **pkey, const char **pval, int *pord);
+
+static size_t      inidb_buf_add      (inidb_buf_t *self, const void *data, size_t size);
+static uint32_t    inidb_buf_str      (inidb_buf_t *self, const char *str);
+static bool        inidb_save         (const char *path, const void *data, size_t size);
+bool               inidb_stamp        (inidb_stamp_t *self, const char *path);
+bool               inidb_write        (const char *path, inifile_t *ini, const inidb_stamp_t *stamps, size_t count);
+
+/* ========================================================================= *
+ * Reading
+ * ========================================================================= */
+
+/** Check that an array fits within file and is properly aligned
+ */
+static bool
+inidb_span_ok(size_t size, uint32_t offs, uint32_t count, size_t elem,
+              size_t align)
+{
+    if( offs % align )
+        return false;
+    if( offs > size )
+        return false;
+    return count <= (size - offs) / elem;
+}
+
+/** Resolve string pool offset
+ *
+ * As the pool ends with NUL, any offset within it is a valid string.
+ */
+static const char *
+inidb_str(const inidb_t *self, uint32_t offs)
+{
+    if( offs >= self->db_head->dh_str_size )
+        return "";
+    return self->db_str + offs;
+}
+
+/** Map database file and validate the header
+ *
+ * @param path  database file path
+ *
+ * @return database object, or NULL if the file is missing or invalid
+ */
+inidb_t *
+inidb_open(const char *path)
+{
+    inidb_t     *self = 0;
+    int          file = -1;
+    void        *data = MAP_FAILED;
+    size_t       size = 0;
+    struct stat  st   = {};
+
+    if( (file = open(path, O_RDONLY | O_CLOEXEC)) == -1 ) {
+        if( errno != ENOENT )
+            log_warning("%s: open: %m", path);
+        goto EXIT;
+    }
+
+    if( fstat(file, &st) == -1 ) {
+        log_warning("%s: fstat: %m", path);
+        goto EXIT;
+    }
+
+    if( !S_ISREG(st.st_mode) || st.st_size < (off_t)sizeof(inidb_head_t) ||
+        st.st_size > (off_t)UINT32_MAX ) {
+        log_warning("%s: not a valid database file", path);
+        goto EXIT;
+    }
+
+    size = (size_t)st.st_size;
+    data = mmap(0, size, PROT_READ, MAP_SHARED, file, 0);
+    if( data == MAP_FAILED ) {
+        log_warning("%s: mmap: %m", path);
+        goto EXIT;
+    }
+
+    const inidb_head_t *head = data;
+
+    if( memcmp(head->dh_magic, INIDB_MAGIC, sizeof head->dh_magic) ||
+        head->dh_version != INIDB_VERSION ||
+        head->dh_endian  != INIDB_ENDIAN  ||
+        head->dh_size    != size ) {
+        log_warning("%s: database version mismatch", path);
+        goto EXIT;
+    }
+
+#define SPAN_OK(offs, count, type) \
+    inidb_span_ok(size, offs, count, sizeof(type), __alignof__(type))
+
+    if( !SPAN_OK(head->dh_src_offs, head->dh_src_count, inidb_src_t) ||
+        !SPAN_OK(head->dh_sec_offs, head->dh_sec_count, inidb_sec_t) ||
+        !SPAN_OK(head->dh_val_offs, head->dh_val_count, inidb_val_t) ||
+        !SPAN_OK(head->dh_str_offs, head->dh_str_size,  char)        ||
+        head->dh_str_size == 0 ||
+        ((const char *)data)[head->dh_str_offs + head->dh_str_size - 1] != 0 ) {
+        log_warning("%s: database is corrupted", path);
+        goto EXIT;
+    }
+
+#undef SPAN_OK
+
+    self = xcalloc(1, sizeof *self);
+    self->db_refs = 1;
+    self->db_data = data;
+    self->db_size = size;
+    self->db_head = head;
+    self->db_src  = (const void *)((const char *)data + head->dh_src_offs);
+    self->db_sec  = (const void *)((const char *)data + head->dh_sec_offs);
+    self->db_val  = (const void *)((const char *)data + head->dh_val_offs);
+    self->db_str  = (const char *)data + head->dh_str_offs;
+    data = MAP_FAILED;
+
+EXIT:
+    if( data != MAP_FAILED )
+        munmap(data, size);
+
+    if( file != -1 )
+        close(file);
+
+    return self;
+}
+
+/** Add reference to database
+ *
+ * Allows sharing one mapping between several inifile_t objects.
+ *
+ * @return self
+ */
+inidb_t *
+inidb_ref(inidb_t *self)
+{
+    if( self )
+        ++self->db_refs;
+    return self;
+}
+
+/** Drop reference, unmap database file when the last one is gone
+ */
+void
+inidb_close(inidb_t *self)
+{
+    if( self && --self->db_refs == 0 ) {
+        munmap((void *)self->db_data, self->db_size);
+        free(self);
+    }
+}
+
+/** Check whether the database was compiled from current source files
+ *
+ * @return true if all stamped files are unmodified, and stamped
+ *         missing files are still missing
+ */
+bool
+inidb_is_current(const inidb_t *self)
+{
+    for( size_t i = 0; i < self->db_head->dh_src_count; ++i ) {
+        const inidb_src_t *src  = self->db_src + i;
+        const char        *path = inidb_str(self, src->ds_path);
+        struct stat        st;
+
+        if( stat(path, &st) == -1 ) {
+            if( errno == ENOENT && src->ds_size == -1 )
+                continue;
+            return false;
+        }
+
+        if( (uint64_t)st.st_ino      != src->ds_ino        ||
+            (int64_t)st.st_size      != src->ds_size       ||
+            (int64_t)st.st_mtim.tv_sec  != src->ds_mtime_sec ||
+            (int64_t)st.st_mtim.tv_nsec != src->ds_mtime_nsec )
+            return false;
+    }
+
+    return true;
+}
+
+/** Number of stamped source paths
+ */
+size_t
+inidb_source_count(const inidb_t *self)
+{
+    return self->db_head->dh_src_count;
+}
+
+/** Source path at given index, in the order given to inidb_write()
+ */
+const char *
+inidb_source_path(const inidb_t *self, size_t ind)
+{
+    return inidb_str(self, self->db_src[ind].ds_path);
+}
+
+/** Largest value ordinal stored in the database
+ */
+int
+inidb_max_ord(const inidb_t *self)
+{
+    return (int)self->db_head->dh_max_ord;
+}
+
+/** Number of sections in the database
+ */
+size_t
+inidb_section_count(const inidb_t *self)
+{
+    return self->db_head->dh_sec_count;
+}
+
+/** Name of section at given index
+ */
+const char *
+inidb_section_name(const inidb_t *self, size_t sec)
+{
+    return inidb_str(self, self->db_sec[sec].ds_name);
+}
+
+/** Locate section by name
+ *
+ * @param name  section name
+ * @param psec  where to store section index
+ *
+ * @return true if section was found, false otherwise
+ */
+bool
+inidb_find_section(const inidb_t *self, const char *name, size_t *psec)
+{
+    size_t lo = 0;
+    size_t hi = inidb_section_count(self);
+
+    while( lo < hi ) {
+        size_t mid = lo + (hi - lo) / 2;
+        int    cmp = strcmp(inidb_section_name(self, mid), name);
+
+        if( cmp == 0 )
+            return *psec = mid, true;
+
+        if( cmp < 0 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return false;
+}
+
+/** Number of values in section at given index
+ */
+size_t
+inidb_value_count(const inidb_t *self, size_t sec)
+{
+    const inidb_sec_t *s = self->db_sec + sec;
+
+    if( s->ds_first > self->db_head->dh_val_count ||
+        s->ds_count > self->db_head->dh_val_count - s->ds_first )
+        return 0;
+
+    return s->ds_count;
+}
+
+/** Get value within a section
+ *
+ * @param sec   section index
+ * @param ind   value index within the section, values are sorted by key
+ *
+ * @return true if value exists, false otherwise
+ */
+bool
+inidb_value(const inidb_t *self, size_t sec, size_t ind,
+            const char **pkey, const char **pval, int *pord)
+{
+    if( ind >= inidb_value_count(self, sec) )
+        return false;
+
+    const inidb_val_t *v = self->db_val + self->db_sec[sec].ds_first + ind;
+
+    *pkey = inidb_str(self, v->dv_key);
+    *pval = inidb_str(self, v->dv_val);
+    *pord = v->dv_ord;
+
+    return true;
+}
+
+/* ========================================================================= *
+ * Writing
+ * ========================================================================= */
+
+/** Append data to buffer
+ *
+ * @return offset at which the data was stored
+ */
+static size_t
+inidb_buf_add(inidb_buf_t *self, const void *data, size_t size)
+{
+    size_t offs = self->ob_size;
+
+    if( self->ob_alloc < offs + size ) {
+        while( self->ob_alloc < offs + size )
+            self->ob_alloc = self->ob_alloc ? self->ob_alloc * 2 : 4096;
+        self->ob_data = xrealloc(self->ob_data, self->ob_alloc);
+    }
+
+    if( data )
+        memcpy(self->ob_data + offs, data, size);
+    else
+        memset(self->ob_data + offs, 0, size);
+
+    self->ob_size += size;
+    return offs;
+}
+
+/** Append string to string pool buffer
+ *
+ * @return pool offset at which the string was stored
+ */
+static uint32_t
+inidb_buf_str(inidb_buf_t *self, const char *str)
+{
+    return (uint32_t)inidb_buf_add(self, str, strlen(str) + 1);
+}
+
+/** Atomically replace database file
+ */
+static bool
+inidb_save(const char *path, const void *data, size_t size)
+{
+    bool    ack  = false;
+    int     file = -1;
+    char   *temp = 0;
+    char   *dir  = xstrdup(path);
+
+    /* Parent directory is normally created at install time */
+    if( mkdir(dirname(dir), 0755) == -1 && errno != EEXIST )
+        log_warning("%s: mkdir: %m", dir);
+
+    if( asprintf(&temp, "%s.XXXXXX", path) == -1 ) {
+        temp = 0;
+        goto EXIT;
+    }
+
+    if( (file = mkstemp(temp)) == -1 ) {
+        log_err("%s: mkstemp: %m", temp);
+        goto EXIT;
+    }
+
+    for( size_t done = 0; done < size; ) {
+        ssize_t rc = write(file, (const char *)data + done, size - done);
+        if( rc == -1 ) {
+            if( errno == EINTR )
+                continue;
+            log_err("%s: write: %m", temp);
+            goto EXIT;
+        }
+        done += (size_t)rc;
+    }
+
+    if( fchmod(file, 0644) == -1 || fsync(file) == -1 ) {
+        log_err("%s: sync: %m", temp);
+        goto EXIT;
+    }
+
+    if( close(file) == -1 ) {
+        file = -1;
+        log_err("%s: close: %m", temp);
+        goto EXIT;
+    }
+    file = -1;
+
+    if( rename(temp, path) == -1 ) {
+        log_err("%s: rename: %m", path);
+        goto EXIT;
+    }
+
+    ack = true;
+
+EXIT:
+    if( file != -1 )
+        close(file);
+
+    if( temp && !ack )
+        unlink(temp);
+
+    free(temp);
+    free(dir);
+
+    return ack;
+}
+
+/** Stamp a source file or directory
+ *
+ * @param self  stamp to fill in
+ * @param path  path to stamp, must stay valid while the stamp is used
+ *
+ * @return true on success, false if path could not be examined
+ */
+bool
+inidb_stamp(inidb_stamp_t *self, const char *path)
+{
+    struct stat st;
+
+    memset(self, 0, sizeof *self);
+    self->is_path = path;
+
+    if( stat(path, &st) == -1 ) {
+        if( errno != ENOENT ) {
+            log_err("%s: stat: %m", path);
+            return false;
+        }
+        self->is_size = -1;
+        return true;
+    }
+
+    self->is_ino        = (uint64_t)st.st_ino;
+    self->is_size       = (int64_t)st.st_size;
+    self->is_mtime_sec  = (int64_t)st.st_mtim.tv_sec;
+    self->is_mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    return true;
+}
+
+/** Compile ini data to a database file
+ *
+ * @param path    database file path
+ * @param ini     merged content of the source files
+ * @param stamps  source files and directories, stamped before parsing
+ * @param count   number of stamps
+ *
+ * @return true on success, false otherwise
+ */
+bool
+inidb_write(const char *path, inifile_t *ini, const inidb_stamp_t *stamps,
+            size_t count)
+{
+    bool          ack  = false;
+    inidb_buf_t   out  = {};
+    inidb_buf_t   str  = {};
+    inidb_head_t  head = {};
+    size_t        nsec = inifile_section_count(ini);
+    size_t        nval = 0;
+    int           ord  = 0;
+
+    for( size_t i = 0; i < nsec; ++i )
+        nval += inisec_elem_count(inifile_elem(ini, i));
+
+    memcpy(head.dh_magic, INIDB_MAGIC, sizeof head.dh_magic);
+    head.dh_version   = INIDB_VERSION;
+    head.dh_endian    = INIDB_ENDIAN;
+    head.dh_src_count = (uint32_t)count;
+    head.dh_sec_count = (uint32_t)nsec;
+    head.dh_val_count = (uint32_t)nval;
+
+    /* Reserve space for header, then emit arrays */
+    inidb_buf_add(&out, 0, sizeof head);
+
+    /* Offset zero in string pool is reserved for empty string */
+    inidb_buf_str(&str, "");
+
+    head.dh_src_offs = (uint32_t)out.ob_size;
+    for( size_t i = 0; i < count; ++i ) {
+        inidb_src_t src = {
+            .ds_path       = inidb_buf_str(&str, stamps[i].is_path),
+            .ds_ino        = stamps[i].is_ino,
+            .ds_size       = stamps[i].is_size,
+            .ds_mtime_sec  = stamps[i].is_mtime_sec,
+            .ds_mtime_nsec = stamps[i].is_mtime_nsec,
+        };
+        inidb_buf_add(&out, &src, sizeof src);
+    }
+
+    /* Sections and values are iterated in name / key order */
+    head.dh_sec_offs = (uint32_t)out.ob_size;
+    nval = 0;
+    for( size_t i = 0; i < nsec; ++i ) {
+        inisec_t   *sec = inifile_elem(ini, i);
+        inidb_sec_t rec = {
+            .ds_name  = inidb_buf_str(&str, inisec_get_name(sec)),
+            .ds_first = (uint32_t)nval,
+            .ds_count = (uint32_t)inisec_elem_count(sec),
+        };
+        inidb_buf_add(&out, &rec, sizeof rec);
+        nval += rec.ds_count;
+    }
+
+    head.dh_val_offs = (uint32_t)out.ob_size;
+    for( size_t i = 0; i < nsec; ++i ) {
+        inisec_t *sec = inifile_elem(ini, i);
+        for( size_t j = 0; j < inisec_elem_count(sec); ++j ) {
+            inival_t   *val = inisec_elem(sec, j);
+            inidb_val_t rec = {
+                .dv_key = inidb_buf_str(&str, inival_get_key(val)),
+                .dv_val = inidb_buf_str(&str, inival_get_val(val)),
+                .dv_ord = inival_get_ord(val),
+            };
+            if( ord < rec.dv_ord )
+                ord = rec.dv_ord;
+            inidb_buf_add(&out, &rec, sizeof rec);
+        }
+    }
+
+    head.dh_str_offs = (uint32_t)out.ob_size;
+    head.dh_str_size = (uint32_t)str.ob_size;
+    inidb_buf_add(&out, str.ob_data, str.ob_size);
+
+    head.dh_max_ord  = (uint32_t)ord;
+    head.dh_size     = (uint32_t)out.ob_size;
+    memcpy(out.ob_data, &head, sizeof head);
+
+    ack = inidb_save(path, out.ob_data, out.ob_size);
+
+    free(str.ob_data);
+    free(out.ob_data);
+
+    return ack;
+}
@@ -0,0 +1,81 @@
+/** @file inidb.h
+ *
+ * ssu-sysinfo - Compiled ini file database
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  INIDB_H_
+# define INIDB_H_
+
+# include "inifile.h"
+
+# include <stddef.h>
+# include <stdbool.h>
+# include <stdint.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Source file stamp
+ *
+ * Taken before the source is parsed, so that changes made while
+ * compiling make the database look out of date. Missing files are
+ * recorded with is_size set to -1.
+ */
+typedef struct
+{
+    const char *is_path;
+    uint64_t    is_ino;
+    int64_t     is_size;
+    int64_t     is_mtime_sec;
+    int64_t     is_mtime_nsec;
+} inidb_stamp_t;
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+inidb_t    *inidb_open          (const char *path);
+inidb_t    *inidb_ref           (inidb_t *self);
+void        inidb_close         (inidb_t *self);
+bool        inidb_is_current    (const inidb_t *self);
+size_t      inidb_source_count  (const inidb_t *self);
+const char *inidb_source_path   (const inidb_t *self, size_t ind);
+int         inidb_max_ord       (const inidb_t *self);
+size_t      inidb_section_count (const inidb_t *self);
+const char *inidb_section_name  (const inidb_t *self, size_t sec);
+bool        inidb_find_section  (const inidb_t *self, const char *name, size_t *psec);
+size_t      inidb_value_count   (const inidb_t *self, size_t sec);
+bool        inidb_value         (const inidb_t *self, size_t sec, size_t ind,
+                                 const char **pkey, const char **pval, int *pord);
+bool        inidb_stamp         (inidb_stamp_t *self, const char *path);
+bool        inidb_write         (const char *path, inifile_t *ini,
+                                 const inidb_stamp_t *stamps, size_t count);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* INIDB_H_ */
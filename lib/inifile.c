@@ -36,6 +36,8 @@
 
 #include "inifile.h"
 
+#include "inidb.h"
+#include "initok.h"
 #include "symtab.h"
 #include "xmalloc.h"
 #include "util.h"
@@ -43,29 +45,69 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
 
 /* ========================================================================= *
- * Config
+ * Types
  * ========================================================================= */
 
-enum
+typedef struct inibuf_t inibuf_t;
+
+struct inival_t
 {
-  BRA = '[',
-  KET = ']',
-  SEP = '=',
+  const char *iv_key; // value key must not be changed
+  const char *iv_val;
+  int         iv_ord;
+  arena_t    *iv_arena;
 };
 
-/* ========================================================================= *
- * inival_t  --  methods
- * ========================================================================= */
+struct inisec_t
+{
+  const char *is_name; // section name must not be changed
+  symtab_t    is_values;
+};
 
-struct inival_t
+/** File content that parsed keys and values point to */
+struct inibuf_t
 {
-  char *iv_key; // value key must not be changed
-  char *iv_val;
-  int   iv_ord;
+  inibuf_t   *ib_next;
+  char       *ib_data;
+  size_t      ib_size;
+};
+
+struct inifile_t
+{
+  arena_t    if_arena;
+  symtab_t   if_sections;
+
+  /* Buffers owned by the inifile */
+  inibuf_t  *if_buffers;
+
+  /* While set, key strings passed to symtab_insert() are known
+   * to live in if_buffers and can be used without copying */
+  int        if_borrow;
+
+  /* Optional compiled database, sections are imported on demand */
+  inidb_t   *if_db;
+
+  /* Value ordinals: index of the file being loaded and number of
+   * values created while loading it */
+  int        if_file;
+  int        if_ord;
 };
 
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Value ordinal is file index * INIVAL_ORD_STRIDE + ordinal within file */
+#define INIVAL_ORD_STRIDE (1 << 20)
+
+/* ========================================================================= *
+ * inival_t  --  methods
+ * ========================================================================= */
+
 /* ------------------------------------------------------------------------- *
  * inival_get_key
  * ------------------------------------------------------------------------- */
@@ -103,50 +145,49 @@ inival_get_ord(const inival_t *self)
 void
 inival_set(inival_t *self, const char *val)
 {
-  strutil_set(&self->iv_val, val);
+  /* Previous value stays in the arena until it is reset */
+  self->iv_val = (val && *val) ? arena_strdup(self->iv_arena, val) : "";
 }
 
 /* ------------------------------------------------------------------------- *
- * inival_create
+ * inival_borrow  --  set value without making a copy
  * ------------------------------------------------------------------------- */
 
-inival_t *
-inival_create(const char *key, const char *val)
+static
+void
+inival_borrow(inival_t *self, const char *val)
 {
-  static int ord = 0;
-
-  inival_t *self = xcalloc(1, sizeof *self);
-
-  self->iv_key = xstrdup(key ?: "");
-  self->iv_val = xstrdup(val ?: "");
-  self->iv_ord = ++ord;
-
-  return self;
+  self->iv_val = val;
 }
 
 /* ------------------------------------------------------------------------- *
- * inival_delete
+ * inival_create_ex
  * ------------------------------------------------------------------------- */
 
-void
-inival_delete(inival_t *self)
+static
+inival_t *
+inival_create_ex(arena_t *arena, const char *key, int borrow, int ord)
 {
-  if( self != 0 )
-  {
-    free(self->iv_key);
-    free(self->iv_val);
-    free(self);
-  }
+  inival_t *self = arena_alloc(arena, sizeof *self);
+
+  self->iv_arena = arena;
+  self->iv_key   = borrow ? key : arena_strdup(arena, key ?: "");
+  self->iv_val   = "";
+  self->iv_ord   = ord;
+
+  return self;
 }
 
 /* ------------------------------------------------------------------------- *
- * inival_delete_cb
+ * inival_create
  * ------------------------------------------------------------------------- */
 
-void
-inival_delete_cb(void *self)
+inival_t *
+inival_create(arena_t *arena, const char *key, const char *val)
 {
-  inival_delete(self);
+  inival_t *self = inival_create_ex(arena, key, 0, 0);
+  inival_set(self, val);
+  return self;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -155,9 +196,11 @@ inival_delete_cb(void *self)
 
 static
 void *
-inival_create_cb(const char *key)
+inival_create_cb(void *aptr, const char *key)
 {
-  return inival_create(key, "");
+  inifile_t *file = aptr;
+  int        ord  = file->if_file * INIVAL_ORD_STRIDE + ++file->if_ord;
+  return inival_create_ex(&file->if_arena, key, file->if_borrow, ord);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -175,12 +218,6 @@ inival_getkey_cb(const void *self)
  * inisec_t  --  methods
  * ========================================================================= */
 
-struct inisec_t
-{
-  char      *is_name; // section name must not be changed
-  symtab_t   is_values;
-};
-
 /* ------------------------------------------------------------------------- *
  * inisec_get_name
  * ------------------------------------------------------------------------- */
@@ -216,14 +253,16 @@ inisec_elem(const inisec_t *self, size_t ind)
  * ------------------------------------------------------------------------- */
 
 void
-inisec_ctor(inisec_t *self)
+inisec_ctor(inisec_t *self, inifile_t *file)
 {
-  self->is_name   = 0;
+  self->is_name   = "";
 
   symtab_ctor(&self->is_values,
+              &file->if_arena,
               inival_create_cb,
-              inival_delete_cb,
-              inival_getkey_cb);
+              0,
+              inival_getkey_cb,
+              file);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -234,8 +273,6 @@ void
 inisec_dtor(inisec_t *self)
 {
   symtab_dtor(&self->is_values);
-
-  strutil_set(&self->is_name, 0);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -243,40 +280,19 @@ inisec_dtor(inisec_t *self)
  * ------------------------------------------------------------------------- */
 
 inisec_t *
-inisec_create(const char *name)
+inisec_create(inifile_t *file, const char *name)
 {
-  inisec_t *self = xcalloc(1, sizeof *self);
-  inisec_ctor(self);
+  inisec_t *self = arena_alloc(&file->if_arena, sizeof *self);
+  inisec_ctor(self, file);
 
-  strutil_set(&self->is_name, name);
+  if( file->if_borrow )
+    self->is_name = name;
+  else
+    self->is_name = arena_strdup(&file->if_arena, name ?: "");
 
   return self;
 }
 
-/* ------------------------------------------------------------------------- *
- * inisec_delete
- * ------------------------------------------------------------------------- */
-
-void
-inisec_delete(inisec_t *self)
-{
-  if( self != 0 )
-  {
-    inisec_dtor(self);
-    free(self);
-  }
-}
-
-/* ------------------------------------------------------------------------- *
- * inisec_delete_cb
- * ------------------------------------------------------------------------- */
-
-void
-inisec_delete_cb(void *self)
-{
-  inisec_delete(self);
-}
-
 /* ------------------------------------------------------------------------- *
  * inisec_getkey_cb
  * ------------------------------------------------------------------------- */
@@ -294,9 +310,9 @@ inisec_getkey_cb(const void *self)
 
 static
 void *
-inisec_create_cb(const char *name)
+inisec_create_cb(void *aptr, const char *name)
 {
-  return inisec_create(name);
+  return inisec_create(aptr, name);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -310,6 +326,19 @@ inisec_set(inisec_t *self, const char *key, const char *val)
   inival_set(res, val);
 }
 
+/* ------------------------------------------------------------------------- *
+ * inisec_put  --  set borrowed value, used while loading files
+ * ------------------------------------------------------------------------- */
+
+static
+inival_t *
+inisec_put(inisec_t *self, const char *key, const char *val)
+{
+  inival_t *res = symtab_insert(&self->is_values, key);
+  inival_borrow(res, val);
+  return res;
+}
+
 /* ------------------------------------------------------------------------- *
  * inisec_get
  * ------------------------------------------------------------------------- */
@@ -325,10 +354,125 @@ inisec_get(inisec_t *self, const char *key, const char *val)
  * inifile_t  --  methods
  * ========================================================================= */
 
-struct inifile_t
+/* ------------------------------------------------------------------------- *
+ * inifile_add_buffer  --  take ownership of file content
+ * ------------------------------------------------------------------------- */
+
+static
+void
+inifile_add_buffer(inifile_t *self, char *data, size_t size)
 {
-  symtab_t   if_sections;
-};
+  inibuf_t *buf = arena_alloc(&self->if_arena, sizeof *buf);
+
+  buf->ib_next = self->if_buffers;
+  buf->ib_data = data;
+  buf->ib_size = size;
+
+  self->if_buffers = buf;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_drop_buffers
+ * ------------------------------------------------------------------------- */
+
+static
+void
+inifile_drop_buffers(inifile_t *self)
+{
+  for( inibuf_t *buf = self->if_buffers; buf; buf = buf->ib_next )
+    free(buf->ib_data);
+
+  self->if_buffers = 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_next_file  --  start assigning ordinals for the next file
+ * ------------------------------------------------------------------------- */
+
+static
+void
+inifile_next_file(inifile_t *self)
+{
+  self->if_file += 1;
+  self->if_ord   = 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_import_section  --  copy section from compiled database
+ * ------------------------------------------------------------------------- */
+
+static
+inisec_t *
+inifile_import_section(inifile_t *self, size_t ind)
+{
+  const inidb_t *db  = self->if_db;
+  inisec_t      *sec = 0;
+  const char    *key = 0;
+  const char    *val = 0;
+  int            ord = 0;
+
+  /* Strings live in the database mapping */
+  self->if_borrow = 1;
+
+  sec = symtab_insert(&self->if_sections, inidb_section_name(db, ind));
+
+  for( size_t i = 0; inidb_value(db, ind, i, &key, &val, &ord); ++i )
+    inisec_put(sec, key, val)->iv_ord = ord;
+
+  self->if_borrow = 0;
+
+  return sec;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_lookup_section  --  find section, import from database if needed
+ * ------------------------------------------------------------------------- */
+
+static
+inisec_t *
+inifile_lookup_section(inifile_t *self, const char *name)
+{
+  inisec_t *sec = symtab_lookup(&self->if_sections, name);
+  size_t    ind = 0;
+
+  if( !sec && self->if_db && inidb_find_section(self->if_db, name, &ind) )
+    sec = inifile_import_section(self, ind);
+
+  return sec;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_import_all  --  import all not yet imported database sections
+ * ------------------------------------------------------------------------- */
+
+static
+void
+inifile_import_all(inifile_t *self)
+{
+  if( !self->if_db )
+    return;
+
+  for( size_t i = 0; i < inidb_section_count(self->if_db); ++i )
+    inifile_lookup_section(self, inidb_section_name(self->if_db, i));
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_attach_db  --  use compiled database as initial content
+ * ------------------------------------------------------------------------- */
+
+void
+inifile_attach_db(inifile_t *self, inidb_t *db)
+{
+  inidb_close(self->if_db);
+  self->if_db = db;
+
+  /* Values loaded later on must be ordered after database content */
+  if( db && self->if_file <= inidb_max_ord(db) / INIVAL_ORD_STRIDE )
+  {
+    self->if_file = inidb_max_ord(db) / INIVAL_ORD_STRIDE;
+    inifile_next_file(self);
+  }
+}
 
 /* ------------------------------------------------------------------------- *
  * inifile_ctor
@@ -337,10 +481,20 @@ struct inifile_t
 void
 inifile_ctor(inifile_t *self)
 {
+  arena_ctor(&self->if_arena);
+
   symtab_ctor(&self->if_sections,
+              &self->if_arena,
               inisec_create_cb,
-              inisec_delete_cb,
-              inisec_getkey_cb);
+              0,
+              inisec_getkey_cb,
+              self);
+
+  self->if_buffers = 0;
+  self->if_borrow  = 0;
+  self->if_db      = 0;
+  self->if_file    = 0;
+  self->if_ord     = 0;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -350,7 +504,36 @@ inifile_ctor(inifile_t *self)
 void
 inifile_dtor(inifile_t *self)
 {
+  inifile_drop_buffers(self);
+  inifile_attach_db(self, 0);
+
+  /* Sections, values and symtab arrays all live in the arena */
   symtab_dtor(&self->if_sections);
+  arena_dtor(&self->if_arena);
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_reset
+ * ------------------------------------------------------------------------- */
+
+void
+inifile_reset(inifile_t *self)
+{
+  inifile_drop_buffers(self);
+  inifile_attach_db(self, 0);
+
+  /* Drop all content, but keep arena memory for reuse */
+  arena_reset(&self->if_arena);
+
+  self->if_file = 0;
+  self->if_ord  = 0;
+
+  symtab_ctor(&self->if_sections,
+              &self->if_arena,
+              inisec_create_cb,
+              0,
+              inisec_getkey_cb,
+              self);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -386,9 +569,24 @@ inifile_delete(inifile_t *self)
 size_t
 inifile_section_count(const inifile_t *self)
 {
+  /* Importing database content does not change logical state */
+  inifile_import_all((inifile_t *)self);
+
   return symtab_size(&self->if_sections);
 }
 
+/* ------------------------------------------------------------------------- *
+ * inifile_elem
+ * ------------------------------------------------------------------------- */
+
+inisec_t *
+inifile_elem(const inifile_t *self, size_t ind)
+{
+  inifile_import_all((inifile_t *)self);
+
+  return symtab_elem(&self->if_sections, ind);
+}
+
 /* ------------------------------------------------------------------------- *
  * inifile_get_section
  * ------------------------------------------------------------------------- */
@@ -396,7 +594,7 @@ inifile_section_count(const inifile_t *self)
 inisec_t *
 inifile_get_section(const inifile_t *self, const char *sec)
 {
-  return symtab_lookup(&self->if_sections, sec);
+  return inifile_lookup_section((inifile_t *)self, sec);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -406,7 +604,7 @@ inifile_get_section(const inifile_t *self, const char *sec)
 inisec_t *
 inifile_add_section(inifile_t *self, const char *sec)
 {
-  return symtab_insert(&self->if_sections, sec);
+  return inifile_lookup_section(self, sec) ?: symtab_insert(&self->if_sections, sec);
 }
 
 /* ------------------------------------------------------------------------- *
@@ -426,92 +624,276 @@ inifile_set(inifile_t *self, const char *sec, const char *key, const char *val)
 const char *
 inifile_get(inifile_t *self, const char *sec, const char *key, const char *val)
 {
-  inisec_t *s = symtab_lookup(&self->if_sections, sec);
+  inisec_t *s = inifile_lookup_section(self, sec);
   return s ? inisec_get(s, key, val) : val;
 }
 
 /* ------------------------------------------------------------------------- *
- * inifile_load
+ * inifile_parse  --  parse NUL terminated file content in place
+ * ------------------------------------------------------------------------- */
+
+static
+void
+inifile_parse(inifile_t *self, char *data, size_t size, const char *defsec)
+{
+  inisec_t *sec = 0;
+  char     *key = 0;
+  char     *val = 0;
+  initok_t  tok;
+
+  /* Values from each file are ordered after all previously loaded ones */
+  inifile_next_file(self);
+
+  if( defsec ) {
+    sec = inifile_add_section(self, defsec);
+  }
+
+  /* Use of default section implies files like /etc/os-release
+   * that are shell scripts rather than ini files and thus can
+   * contain quoted values.
+   */
+  initok_ctor(&tok, data, size, defsec != 0);
+
+  /* Keys and values are slices of the data buffer */
+  self->if_borrow = 1;
+
+  for( ;; )
+  {
+    initok_type_t type = initok_next(&tok, &key, &val);
+
+    if( type == INITOK_EOF )
+      break;
+
+    if( type == INITOK_SECTION )
+      sec = inifile_add_section(self, key);
+    else if( sec )
+      inisec_put(sec, key, val);
+  }
+
+  self->if_borrow = 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_load_buffer  --  parse ini content held in memory
  * ------------------------------------------------------------------------- */
 
 int
-inifile_load(inifile_t *self, const char *path, const char *defsec)
+inifile_load_buffer(inifile_t *self, const char *data, size_t size,
+                    const char *defsec)
+{
+  /* Parsing is done in place and the results refer to the content,
+   * so take a private copy that lives as long as the inifile does */
+  char *copy = arena_alloc(&self->if_arena, size + 1);
+
+  memcpy(copy, data, size);
+  copy[size] = 0;
+
+  inifile_parse(self, copy, size, defsec);
+
+  return 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_load_fd  --  parse ini content from an open file
+ * ------------------------------------------------------------------------- */
+
+int
+inifile_load_fd(inifile_t *self, int fd, const char *defsec)
 {
-  int     err  = -1;
-  FILE   *file = 0;
   size_t  size = 0;
   char   *data = 0;
 
-  inisec_t *sec = 0;
-  char     *key = 0;
-  char     *val = 0;
+  /* Parsed keys and values keep pointing to the content for as long
+   * as the inifile lives. A private file mapping would not do: pages
+   * get discarded - even modified ones - when the file is truncated,
+   * e.g. when it is rewritten in place, and touching pages past the
+   * new end of file raises SIGBUS. */
+  if( !(data = fileutil_read_fd(fd, &size)) )
+    return -1;
+
+  return inifile_load_owned(self, data, size, defsec);
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_load_owned  --  parse ini content and take ownership of it
+ * ------------------------------------------------------------------------- */
+
+int
+inifile_load_owned(inifile_t *self, char *data, size_t size,
+                   const char *defsec)
+{
+  /* Content must be allocated via malloc() and NUL terminated */
+  inifile_add_buffer(self, data, size);
+  inifile_parse(self, data, size, defsec);
+
+  return 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_load
+ * ------------------------------------------------------------------------- */
+
+int
+inifile_load(inifile_t *self, const char *path, const char *defsec)
+{
+  int     err  = -1;
+  int     file = -1;
 
   log_debug("read: %s, using default section: %s", path, defsec ?: "N/A");
 
-  if( (file = fopen(path, "r")) == 0 )
+  if( (file = open(path, O_RDONLY | O_CLOEXEC)) == -1 )
   {
     log_debug("%s: iniload/open: %m", path);
     goto cleanup;
   }
 
-  if( defsec ) {
-    sec = inifile_add_section(self, defsec);
+  if( (err = inifile_load_fd(self, file, defsec)) == -1 )
+    log_warning("%s: iniload/read failed", path);
+
+cleanup:
+
+  if( file != -1 && close(file) == -1 )
+  {
+    log_err("%s: iniload/close: %m", path);
+    err = -1;
   }
 
-  while( getline(&data, &size, file) != -1 )
+  return err;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_scan  --  stream entries from a file without building inifile_t
+ * ------------------------------------------------------------------------- */
+
+int
+inifile_scan(const char *path, const char *defsec,
+             inifile_scan_fn cb, void *aptr)
+{
+  int         res  = -1;
+  int         file = -1;
+  size_t      size = 0;
+  char       *data = 0;
+  const char *sec  = defsec;
+  char       *key  = 0;
+  char       *val  = 0;
+  initok_t    tok;
+
+  log_debug("scan: %s, using default section: %s", path, defsec ?: "N/A");
+
+  if( (file = open(path, O_RDONLY | O_CLOEXEC)) == -1 )
   {
-    char *pos = strutil_trim(data);
+    log_debug("%s: iniscan/open: %m", path);
+    goto cleanup;
+  }
 
-    if( *pos == 0 ) continue;
+  /* Content is read to heap rather than mapped: accessing a mapping
+   * past the end of a file that got truncated meanwhile raises SIGBUS */
+  if( !(data = fileutil_read_fd(file, &size)) )
+  {
+    log_warning("%s: iniscan/read failed", path);
+    goto cleanup;
+  }
 
-    if( *pos == ';' || *pos == '#' ) continue;
+  /* Same tokenizer and quoting rules as in inifile_load() */
+  initok_ctor(&tok, data, size, defsec != 0);
 
-    if( *pos == BRA )
-    {
-      char *name = strutil_slice(pos+1, 0, KET);
-      sec = inifile_add_section(self, strutil_strip(name));
-      continue;
-    }
+  res = 0;
+
+  for( ;; )
+  {
+    initok_type_t type = initok_next(&tok, &key, &val);
 
-    key = strutil_slice(pos, &val, SEP);
-    strutil_strip(key);
-    strutil_trim(val);
+    if( type == INITOK_EOF )
+      break;
 
-    if( sec && *key )
+    if( type == INITOK_SECTION )
+      sec = key;
+    else if( sec && !cb(sec, key, val, aptr) )
     {
-      if( defsec )
-      {
-        /* Use of default section implies files like /etc/os-release
-         * that are shell scripts rather than ini files and thus can
-         * contain quoted values.
-         */
-        if( *val == '"' || *val == '\'' )
-        {
-          char *end = strrchr(val + 1, *val);
-          if( end )
-          {
-            *end = 0;
-            strutil_trim(++val);
-          }
-        }
-      }
-      inisec_set(sec, key, val);
+      res = 1;
+      break;
     }
   }
 
-  err = 0;
-
 cleanup:
 
   free(data);
 
-  if( file != 0 && fclose(file) == EOF )
+  if( file != -1 && close(file) == -1 )
+    log_err("%s: iniscan/close: %m", path);
+
+  return res;
+}
+
+/* ------------------------------------------------------------------------- *
+ * inifile_owns_string  --  check if string lives in a file buffer
+ * ------------------------------------------------------------------------- */
+
+static
+int
+inifile_owns_string(const inifile_t *self, const char *str)
+{
+  for( const inibuf_t *buf = self->if_buffers; buf; buf = buf->ib_next )
   {
-    log_err("%s: iniload/close: %m", path);
-    err = -1;
+    if( str >= buf->ib_data && str <= buf->ib_data + buf->ib_size )
+      return 1;
   }
+  return 0;
+}
 
-  return err;
+/* ------------------------------------------------------------------------- *
+ * inifile_merge  --  move content of one inifile on top of another
+ * ------------------------------------------------------------------------- */
+
+void
+inifile_merge(inifile_t *self, inifile_t *src)
+{
+  /* The result is the same as loading the files that src was loaded
+   * from directly into self: values override existing ones, and new
+   * values are ordered after all previously loaded content. Strings
+   * that live in file buffers are taken over instead of copied. */
+  inifile_next_file(self);
+
+  for( size_t i = 0; i < inifile_section_count(src); ++i )
+  {
+    inisec_t   *ssec = inifile_elem(src, i);
+    const char *name = inisec_get_name(ssec);
+    inisec_t   *dsec = inifile_lookup_section(self, name);
+
+    if( !dsec )
+    {
+      self->if_borrow = inifile_owns_string(src, name);
+      dsec = symtab_insert(&self->if_sections, name);
+    }
+
+    for( size_t j = 0; j < inisec_elem_count(ssec); ++j )
+    {
+      inival_t   *sval = inisec_elem(ssec, j);
+      const char *key  = inival_get_key(sval);
+      const char *val  = inival_get_val(sval);
+      inival_t   *dval = symtab_lookup(&dsec->is_values, key);
+
+      if( !dval )
+      {
+        self->if_borrow = inifile_owns_string(src, key);
+        dval = symtab_insert(&dsec->is_values, key);
+        dval->iv_ord = (self->if_file * INIVAL_ORD_STRIDE +
+                        inival_get_ord(sval) % INIVAL_ORD_STRIDE);
+      }
+
+      if( inifile_owns_string(src, val) )
+        inival_borrow(dval, val);
+      else
+        inival_set(dval, val);
+    }
+  }
+
+  self->if_borrow = 0;
+
+  /* Buffer bookkeeping lives in the arena of src, which is not moved */
+  for( inibuf_t *buf = src->if_buffers; buf; buf = buf->ib_next )
+    inifile_add_buffer(self, buf->ib_data, buf->ib_size);
+  src->if_buffers = 0;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -522,7 +904,7 @@ void
 inifile_dump(inifile_t *self)
 {
   for( size_t i = 0; i < inifile_section_count(self); ++i ) {
-    inisec_t *sec = symtab_elem(&self->if_sections, i);
+    inisec_t *sec = inifile_elem(self, i);
     printf("[%s]\n", inisec_get_name(sec));
 
     for( size_t j = 0; j < inisec_elem_count(sec); ++j ) {
@@ -36,7 +36,10 @@
 #ifndef INIFILE_H_
 # define INIFILE_H_
 
+# include "arena.h"
+
 # include <stdio.h>
+# include <stdbool.h>
 
 # ifdef __cplusplus
 extern "C" {
@@ -51,6 +54,11 @@ extern "C" {
 typedef struct inifile_t inifile_t;
 typedef struct inisec_t  inisec_t;
 typedef struct inival_t  inival_t;
+typedef struct inidb_t   inidb_t;
+
+/** Callback for inifile_scan(); return false to stop scanning */
+typedef bool (*inifile_scan_fn)(const char *sec, const char *key,
+                                const char *val, void *aptr);
 
 /* ========================================================================= *
  * Functions
@@ -64,10 +72,8 @@ const char *inival_get_key   (const inival_t *self);
 const char *inival_get_val   (const inival_t *self);
 int         inival_get_ord   (const inival_t *self);
 void        inival_set       (inival_t *self, const char *val);
-inival_t   *inival_create    (const char *key, const char *val);
-void        inival_delete    (inival_t *self);
+inival_t   *inival_create    (arena_t *arena, const char *key, const char *val);
 int         inival_compare   (const inival_t *self, const char *key);
-void        inival_delete_cb (void *self);
 
 /* ------------------------------------------------------------------------- *
  * inisec_t
@@ -76,12 +82,10 @@ void        inival_delete_cb (void *self);
 size_t      inisec_elem_count(const inisec_t *self);
 inival_t   *inisec_elem      (const inisec_t *self, size_t ind);
 const char *inisec_get_name  (const inisec_t *self);
-void        inisec_ctor      (inisec_t *self);
+void        inisec_ctor      (inisec_t *self, inifile_t *file);
 void        inisec_dtor      (inisec_t *self);
-inisec_t   *inisec_create    (const char *name);
-void        inisec_delete    (inisec_t *self);
+inisec_t   *inisec_create    (inifile_t *file, const char *name);
 int         inisec_compare   (const inisec_t *self, const char *name);
-void        inisec_delete_cb (void *self);
 void        inisec_set       (inisec_t *self, const char *key, const char *val);
 const char *inisec_get       (inisec_t *self, const char *key, const char *val);
 int         inisec_has       (inisec_t *self, const char *key);
@@ -93,14 +97,22 @@ void        inisec_del       (inisec_t *self, const char *key);
 
 void         inifile_ctor             (inifile_t *self);
 void         inifile_dtor             (inifile_t *self);
+void         inifile_reset            (inifile_t *self);
 inifile_t  * inifile_create           (void);
 void         inifile_delete           (inifile_t *self);
+void         inifile_attach_db        (inifile_t *self, inidb_t *db);
 size_t       inifile_section_count    (const inifile_t *self);
+inisec_t   * inifile_elem             (const inifile_t *self, size_t ind);
 inisec_t   * inifile_get_section      (const inifile_t *self, const char *sec);
 inisec_t   * inifile_add_section      (inifile_t *self, const char *sec);
 void         inifile_set              (inifile_t *self, const char *sec, const char *key, const char *val);
 const char * inifile_get              (inifile_t *self, const char *sec, const char *key, const char *val);
+int          inifile_load_buffer      (inifile_t *self, const char *data, size_t size, const char *defsec);
+int          inifile_load_fd          (inifile_t *self, int fd, const char *defsec);
+int          inifile_load_owned       (inifile_t *self, char *data, size_t size, const char *defsec);
 int          inifile_load             (inifile_t *self, const char *path, const char *defsec);
+int          inifile_scan             (const char *path, const char *defsec, inifile_scan_fn cb, void *aptr);
+void         inifile_merge            (inifile_t *self, inifile_t *src);
 void         inifile_dump             (inifile_t *self);
 
 # ifdef __cplusplus
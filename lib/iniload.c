@@ -0,0 +1,228 @@
+/** @file iniload.c
+ *
+ * ssu-sysinfo - Loading sets of ini files
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "iniload.h"
+
+#include "filebatch.h"
+#include "xmalloc.h"
+#include "logging.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Upper limit for number of threads used for parsing files */
+#define INILOAD_MAX_THREADS 8
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Set of files to parse, shared by all worker threads */
+typedef struct
+{
+    filebatch_t  *lj_files;  // file content to parse
+    const char   *lj_defsec; // default section, or NULL
+    inifile_t   **lj_parts;  // parsed content, one per file
+    size_t        lj_count;  // number of files
+    size_t        lj_next;   // index of the next unclaimed file
+} iniload_job_t;
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static void  iniload_parse        (inifile_t *ini, filebatch_t *file, const char *defsec);
+static void *iniload_worker       (void *aptr);
+static void  iniload_threads_init (void);
+int          iniload_threads      (void);
+void         iniload_files        (inifile_t *ini, char * const *paths, size_t count, const char *defsec);
+
+/* ========================================================================= *
+ * Worker threads
+ * ========================================================================= */
+
+/** Parse file content, ownership of which is passed to the config object
+ */
+static void
+iniload_parse(inifile_t *ini, filebatch_t *file, const char *defsec)
+{
+    if( file->fb_data ) {
+        log_debug("parse: %s, using default section: %s",
+                  file->fb_path, defsec ?: "N/A");
+        inifile_load_owned(ini, file->fb_data, file->fb_size, defsec);
+        file->fb_data = 0;
+    }
+}
+
+/** Parse files into private config objects until none are left
+ *
+ * @param aptr  job object pointer
+ *
+ * @return NULL
+ */
+static void *
+iniload_worker(void *aptr)
+{
+    iniload_job_t *job = aptr;
+
+    for( ;; ) {
+        size_t ind = __atomic_fetch_add(&job->lj_next, 1, __ATOMIC_RELAXED);
+        if( ind >= job->lj_count )
+            break;
+
+        job->lj_parts[ind] = inifile_create();
+        iniload_parse(job->lj_parts[ind], &job->lj_files[ind], job->lj_defsec);
+    }
+
+    return 0;
+}
+
+/* ========================================================================= *
+ * Loading
+ * ========================================================================= */
+
+/** Number of threads to use, evaluated once per process */
+static int iniload_threads_cached = 0;
+
+/** Evaluate number of threads to use from environment
+ */
+static void
+iniload_threads_init(void)
+{
+    int use = 0;
+
+    const char *env = getenv("SSUSYSINFO_LOAD_THREADS");
+    if( env )
+        use = strtol(env, 0, 0);
+
+    if( use < 0 )
+        use = 0;
+
+    if( use > INILOAD_MAX_THREADS )
+        use = INILOAD_MAX_THREADS;
+
+    iniload_threads_cached = use;
+}
+
+/** Number of threads to use for parsing sets of files
+ *
+ * Parallel parsing is opt-in: it pays off only with large sets of
+ * files on multicore devices, and is pure overhead otherwise. The
+ * number of threads is taken from SSUSYSINFO_LOAD_THREADS environment
+ * variable.
+ *
+ * Can be called from any thread.
+ *
+ * @return number of threads, or 0 for loading files sequentially
+ */
+int
+iniload_threads(void)
+{
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+    pthread_once(&once, iniload_threads_init);
+
+    return iniload_threads_cached;
+}
+
+/** Load a set of ini files into a config object
+ *
+ * The result is the same as calling inifile_load() for each file
+ * in the given order. All files are read in one batch, and then
+ * parsed either directly, or into private config objects in parallel
+ * and merged in order.
+ *
+ * @param ini     config object to load data into
+ * @param paths   array of file paths
+ * @param count   number of paths
+ * @param defsec  default section, or NULL
+ */
+void
+iniload_files(inifile_t *ini, char * const *paths, size_t count,
+              const char *defsec)
+{
+    pthread_t     tids[INILOAD_MAX_THREADS];
+    size_t        started = 0;
+    size_t        threads = (size_t)iniload_threads();
+    filebatch_t  *files   = xcalloc(count ?: 1, sizeof *files);
+    iniload_job_t job     = {
+        .lj_files  = files,
+        .lj_defsec = defsec,
+        .lj_parts  = 0,
+        .lj_count  = count,
+        .lj_next   = 0,
+    };
+
+    for( size_t i = 0; i < count; ++i )
+        files[i].fb_path = paths[i];
+
+    filebatch_read(files, count);
+
+    if( threads > count )
+        threads = count;
+
+    if( threads < 2 ) {
+        for( size_t i = 0; i < count; ++i )
+            iniload_parse(ini, &files[i], defsec);
+        goto EXIT;
+    }
+
+    job.lj_parts = xcalloc(count, sizeof *job.lj_parts);
+
+    /* Signals are left for the threads of the application to handle */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    /* The calling thread does its share of the work too */
+    for( size_t i = 1; i < threads; ++i ) {
+        int err = pthread_create(&tids[started], 0, iniload_worker, &job);
+        if( err ) {
+            log_warning("pthread_create: %s", strerror(err));
+            break;
+        }
+        ++started;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, 0);
+
+    iniload_worker(&job);
+
+    for( size_t i = 0; i < started; ++i )
+        pthread_join(tids[i], 0);
+
+    for( size_t i = 0; i < count; ++i ) {
+        inifile_merge(ini, job.lj_parts[i]);
+        inifile_delete(job.lj_parts[i]);
+    }
+
+    free(job.lj_parts);
+
+EXIT:
+    free(files);
+    return;
+}
@@ -0,0 +1,47 @@
+/** @file iniload.h
+ *
+ * ssu-sysinfo - Loading sets of ini files
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  INILOAD_H_
+# define INILOAD_H_
+
+# include "inifile.h"
+
+# include <stddef.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+int  iniload_threads (void);
+void iniload_files   (inifile_t *ini, char * const *paths, size_t count,
+                      const char *defsec);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* INILOAD_H_ */
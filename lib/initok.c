@@ -0,0 +1,350 @@
+/** @file initok.c
+ *
+ * ssu-sysinfo - Ini file tokenizer
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "initok.h"
+
+#include "util.h"
+
+#include <string.h>
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Number of bytes classified in one go */
+#define INITOK_BLOCK 16
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Character class bitmasks for one block of input
+ *
+ * Bit N describes byte N of the block.
+ */
+typedef struct
+{
+    unsigned bm_eol;   // line feed or NUL
+    unsigned bm_sep;   // '='
+    unsigned bm_black; // non-whitespace, i.e. above ASCII space
+    unsigned bm_space; // ASCII space
+} initok_masks_t;
+
+/** Interesting positions within one line
+ *
+ * All pointers are NULL when the feature does not exist in the line.
+ */
+typedef struct
+{
+    char *il_eol;     // line feed / NUL / end of content
+    char *il_first;   // first non-whitespace char
+    char *il_last;    // last non-whitespace char
+    char *il_sep;     // first '='
+    char *il_value;   // first non-whitespace char after il_sep
+    char *il_odd;     // first whitespace after il_first that is not
+                      // a single space between non-whitespace chars
+} initok_line_t;
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static inline bool     initok_at_white    (const char *pos);
+static inline unsigned initok_lowest      (unsigned mask);
+static inline unsigned initok_highest     (unsigned mask);
+static void            initok_classify    (const char *blk, size_t len, initok_masks_t *bm);
+#ifdef __SSE2__
+static void            initok_classify_sse2(const char *blk, initok_masks_t *bm);
+#endif
+static void            initok_scan        (initok_line_t *ln, char *pos, char *end);
+static char           *initok_strip       (char *beg, char *end, const char *odd);
+void                   initok_ctor        (initok_t *self, char *data, size_t size, bool unquote);
+initok_type_t          initok_next        (initok_t *self, char **pkey, char **pval);
+
+/* ========================================================================= *
+ * Character classification
+ * ========================================================================= */
+
+/** At white space char predicate; same rules as in strutil_trim()
+ */
+static inline bool
+initok_at_white(const char *pos)
+{
+    int chr = (unsigned char)*pos;
+    return (chr > 0) && (chr <= 32);
+}
+
+/** Index of the lowest set bit in a non-zero mask
+ */
+static inline unsigned
+initok_lowest(unsigned mask)
+{
+    return (unsigned)__builtin_ctz(mask);
+}
+
+/** Index of the highest set bit in a non-zero mask
+ */
+static inline unsigned
+initok_highest(unsigned mask)
+{
+    return 31u - (unsigned)__builtin_clz(mask);
+}
+
+/** Classify up to INITOK_BLOCK bytes one at a time
+ */
+static void
+initok_classify(const char *blk, size_t len, initok_masks_t *bm)
+{
+    unsigned eol = 0, sep = 0, black = 0, space = 0;
+
+    for( size_t i = 0; i < len; ++i ) {
+        unsigned chr = (unsigned char)blk[i];
+        unsigned bit = 1u << i;
+
+        if( chr == '\n' || chr == 0 ) eol   |= bit;
+        if( chr == '=' )              sep   |= bit;
+        if( chr >  ' ' )              black |= bit;
+        if( chr == ' ' )              space |= bit;
+    }
+
+    /* Bytes past the end of content act as end of line */
+    for( size_t i = len; i < INITOK_BLOCK; ++i )
+        eol |= 1u << i;
+
+    bm->bm_eol   = eol;
+    bm->bm_sep   = sep;
+    bm->bm_black = black;
+    bm->bm_space = space;
+}
+
+#ifdef __SSE2__
+/** Classify INITOK_BLOCK bytes in parallel
+ */
+static void
+initok_classify_sse2(const char *blk, initok_masks_t *bm)
+{
+    const __m128i v = _mm_loadu_si128((const __m128i *)blk);
+
+    /* SSE2 has only signed byte compare; flip the sign bit so
+     * that "chr > 32" works also for chars in 128...255 range */
+    const __m128i u = _mm_xor_si128(v, _mm_set1_epi8((char)0x80));
+    const __m128i w = _mm_set1_epi8((char)(' ' ^ 0x80));
+
+    __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                               _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+
+    bm->bm_eol   = (unsigned)_mm_movemask_epi8(eol);
+    bm->bm_sep   = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('=')));
+    bm->bm_black = (unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(u, w));
+    bm->bm_space = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+}
+#endif
+
+/* ========================================================================= *
+ * Line scanning
+ * ========================================================================= */
+
+/** Locate line end, separator and whitespace boundaries in one pass
+ */
+static void
+initok_scan(initok_line_t *ln, char *pos, char *end)
+{
+    memset(ln, 0, sizeof *ln);
+
+    unsigned prev_white = 0;
+
+    for( char *blk = pos; ; blk += INITOK_BLOCK ) {
+        initok_masks_t bm;
+        size_t         len = (size_t)(end - blk);
+
+#ifdef __SSE2__
+        if( len >= INITOK_BLOCK )
+            initok_classify_sse2(blk, &bm);
+        else
+#endif
+            initok_classify(blk, len < INITOK_BLOCK ? len : INITOK_BLOCK, &bm);
+
+        /* Ignore everything from the end of line onwards */
+        unsigned keep = 0xffffu;
+        if( bm.bm_eol )
+            keep = (1u << initok_lowest(bm.bm_eol)) - 1;
+
+        unsigned black = bm.bm_black & keep;
+        unsigned sep   = bm.bm_sep   & keep;
+        unsigned white = ~bm.bm_black & keep;
+
+        /* Whitespace that strutil_strip() would need to squeeze */
+        unsigned odd = (white & ~bm.bm_space) | (white & ((white << 1) | prev_white));
+        prev_white = (white >> (INITOK_BLOCK - 1)) & 1;
+
+        if( black ) {
+            if( !ln->il_first ) {
+                unsigned bit = initok_lowest(black);
+                ln->il_first = blk + bit;
+                odd &= ~((2u << bit) - 1);
+            }
+            ln->il_last = blk + initok_highest(black);
+        }
+        else if( !ln->il_first ) {
+            odd = 0;
+        }
+
+        if( odd && !ln->il_odd )
+            ln->il_odd = blk + initok_lowest(odd);
+
+        if( !ln->il_value ) {
+            unsigned after = black;
+            if( !ln->il_sep && sep ) {
+                unsigned bit = initok_lowest(sep);
+                ln->il_sep = blk + bit;
+                after &= ~((2u << bit) - 1);
+            }
+            if( ln->il_sep && after )
+                ln->il_value = blk + initok_lowest(after);
+        }
+
+        if( keep != 0xffffu ) {
+            ln->il_eol = blk + initok_lowest(bm.bm_eol);
+            break;
+        }
+    }
+}
+
+/** Terminate a string and squeeze whitespace like strutil_strip() does
+ *
+ * @param beg  first char of the string
+ * @param end  one past the last char of the string
+ * @param odd  first irregular whitespace char in the line, or NULL
+ */
+static char *
+initok_strip(char *beg, char *end, const char *odd)
+{
+    if( odd && odd < end ) {
+        *end = 0;
+        return strutil_strip(beg);
+    }
+
+    /* At most single spaces between words; just trim the ends */
+    while( beg < end && initok_at_white(beg) ) ++beg;
+    while( end > beg && initok_at_white(end - 1) ) --end;
+    *end = 0;
+    return beg;
+}
+
+/* ========================================================================= *
+ * Tokenizer
+ * ========================================================================= */
+
+/** Initialize tokenizer state
+ *
+ * @param data     writable content, data[size] must be NUL
+ * @param size     content size
+ * @param unquote  true to strip quotes from values
+ */
+void
+initok_ctor(initok_t *self, char *data, size_t size, bool unquote)
+{
+    self->it_pos     = data;
+    self->it_end     = data + size;
+    self->it_unquote = unquote;
+}
+
+/** Get next section header or key-value entry
+ *
+ * Empty lines, comments and entries with empty key are skipped.
+ * Whitespace handling is identical to what trimming lines with
+ * strutil_trim(), splitting them with strutil_slice() and then
+ * normalizing keys and section names with strutil_strip() would
+ * produce - but all of it is done in one pass over the content.
+ *
+ * @param pkey  where to store section name / entry key
+ * @param pval  where to store entry value
+ *
+ * @return token type, or INITOK_EOF
+ */
+initok_type_t
+initok_next(initok_t *self, char **pkey, char **pval)
+{
+    char *end = self->it_end;
+
+    while( self->it_pos < end ) {
+        initok_line_t ln;
+        initok_scan(&ln, self->it_pos, end);
+
+        /* Stray NUL ends line content, the line itself ends at LF */
+        char *eol = ln.il_eol;
+        if( *eol == '\n' )
+            self->it_pos = eol + 1;
+        else if( !(self->it_pos = memchr(eol, '\n', (size_t)(end - eol))) )
+            self->it_pos = end;
+        else
+            self->it_pos += 1;
+        *eol = 0;
+
+        char *first = ln.il_first;
+        char *last  = ln.il_last;
+
+        if( !first || *first == ';' || *first == '#' )
+            continue;
+
+        if( *first == '[' ) {
+            char *name = first + 1;
+            char *stop = memchr(name, ']', (size_t)(last + 1 - name)) ?: last + 1;
+            *pkey = initok_strip(name, stop, ln.il_odd);
+            *pval = 0;
+            return INITOK_SECTION;
+        }
+
+        char *key = first;
+        char *val = "";
+
+        if( ln.il_sep ) {
+            if( ln.il_sep == first )
+                continue;
+            if( (val = ln.il_value) ) {
+                last[1] = 0;
+                if( self->it_unquote && (*val == '"' || *val == '\'') ) {
+                    char *quote = memrchr(val + 1, *val, (size_t)(last - val));
+                    if( quote ) {
+                        *quote = 0;
+                        val = strutil_trim(val + 1);
+                    }
+                }
+            }
+            else {
+                val = "";
+            }
+            *pkey = initok_strip(key, ln.il_sep, ln.il_odd);
+        }
+        else {
+            *pkey = initok_strip(key, last + 1, ln.il_odd);
+        }
+
+        *pval = val;
+        return INITOK_ENTRY;
+    }
+
+    return INITOK_EOF;
+}
@@ -0,0 +1,71 @@
+/** @file initok.h
+ *
+ * ssu-sysinfo - Ini file tokenizer
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  INITOK_H_
+# define INITOK_H_
+
+# include <stddef.h>
+# include <stdbool.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Token types returned by initok_next() */
+typedef enum
+{
+    INITOK_EOF,      // no more content
+    INITOK_SECTION,  // section header, name in key
+    INITOK_ENTRY,    // key = value line
+} initok_type_t;
+
+typedef struct initok_t initok_t;
+
+/** Ini file tokenizer state
+ *
+ * Splits writable, NUL terminated ini file content into sections and
+ * key-value entries in place. Returned strings point to the buffer.
+ */
+struct initok_t
+{
+    char *it_pos;     // start of the next line
+    char *it_end;     // end of content, must point to NUL byte
+    bool  it_unquote; // strip quotes from values, as in shell scripts
+};
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+void          initok_ctor (initok_t *self, char *data, size_t size, bool unquote);
+initok_type_t initok_next (initok_t *self, char **pkey, char **pval);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* INITOK_H_ */
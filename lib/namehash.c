@@ -0,0 +1,104 @@
+/** @file namehash.c
+ *
+ * ssu-sysinfo - Minimal perfect hashing of case insensitive names
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "namehash.h"
+
+/* The same functions are used by util/namehash-gen for building the
+ * tables, and by the library for lookups. Changing any of them
+ * changes the generated tables, but not their validity.
+ *
+ * Names are hashed once; the upper half of the hash selects a bucket,
+ * and the lower half mixed with the displacement value of the bucket
+ * selects the slot.
+ */
+
+/** Hash a name with ASCII case folding
+ *
+ * @param name  c-string
+ * @param seed  hash seed
+ *
+ * @return 64-bit FNV-1a hash of lower case version of name
+ */
+uint64_t
+namehash_fold(const char *name, uint32_t seed)
+{
+    uint64_t hash = UINT64_C(0xcbf29ce484222325) ^ seed;
+
+    for( const unsigned char *pos = (const unsigned char *)name; *pos; ++pos ) {
+        unsigned chr = *pos;
+        if( chr >= 'A' && chr <= 'Z' )
+            chr += 'a' - 'A';
+        hash = (hash ^ chr) * UINT64_C(0x100000001b3);
+    }
+
+    return hash;
+}
+
+/** Get bucket of a name hash
+ *
+ * @param hash     value from namehash_fold()
+ * @param buckets  number of buckets
+ *
+ * @return bucket index
+ */
+uint32_t
+namehash_bucket(uint64_t hash, uint32_t buckets)
+{
+    return (uint32_t)(hash >> 32) % buckets;
+}
+
+/** Get slot of a name hash
+ *
+ * @param hash   value from namehash_fold()
+ * @param disp   displacement value of the bucket
+ * @param count  number of slots
+ *
+ * @return slot index
+ */
+uint32_t
+namehash_slot(uint64_t hash, uint32_t disp, uint32_t count)
+{
+    uint32_t mix = (uint32_t)hash ^ (disp * UINT32_C(0x9e3779b9));
+
+    mix ^= mix >> 16;
+    mix *= UINT32_C(0x85ebca6b);
+    mix ^= mix >> 13;
+    mix *= UINT32_C(0xc2b2ae35);
+    mix ^= mix >> 16;
+
+    return mix % count;
+}
+
+/** Lookup candidate table index for a name
+ *
+ * @param self  generated hash table
+ * @param name  c-string
+ *
+ * @return index that is valid for the table, but must be verified
+ */
+size_t
+namehash_lookup(const namehash_t *self, const char *name)
+{
+    uint64_t hash = namehash_fold(name, self->nh_seed);
+    uint32_t disp = self->nh_disp[namehash_bucket(hash, self->nh_buckets)];
+
+    return self->nh_slot[namehash_slot(hash, disp, self->nh_count)];
+}
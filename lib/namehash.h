@@ -0,0 +1,66 @@
+/** @file namehash.h
+ *
+ * ssu-sysinfo - Minimal perfect hashing of case insensitive names
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef  NAMEHASH_H_
+# define NAMEHASH_H_
+
+# include <stddef.h>
+# include <stdint.h>
+
+# ifdef __cplusplus
+extern "C" {
+# elif 0
+} /* fool JED indentation ... */
+# endif
+
+/* ========================================================================= *
+ * Types
+ * ========================================================================= */
+
+/** Minimal perfect hash table generated by util/namehash-gen
+ *
+ * Maps every name in a fixed table to a distinct index, ignoring
+ * case. Names not in the table map to arbitrary indices, so callers
+ * must verify the candidate with strcasecmp().
+ */
+typedef struct
+{
+    uint32_t        nh_seed;    // seed for the first level hash
+    uint32_t        nh_buckets; // number of displacement values
+    uint32_t        nh_count;   // number of names
+    const uint16_t *nh_disp;    // displacement value for each bucket
+    const uint16_t *nh_slot;    // table index for each slot
+} namehash_t;
+
+/* ========================================================================= *
+ * Functions
+ * ========================================================================= */
+
+uint64_t namehash_fold   (const char *name, uint32_t seed);
+uint32_t namehash_bucket (uint64_t hash, uint32_t buckets);
+uint32_t namehash_slot   (uint64_t hash, uint32_t disp, uint32_t count);
+size_t   namehash_lookup (const namehash_t *self, const char *name);
+
+# ifdef __cplusplus
+};
+# endif
+
+#endif /* NAMEHASH_H_ */
@@ -23,20 +23,29 @@
 
 #include "ssusysinfo.h"
 
+#include "acmatch.h"
+#include "inidb.h"
 #include "inifile.h"
+#include "iniload.h"
 #include "xmalloc.h"
 #include "util.h"
 #include "hw_key.h"
 #include "hw_feature.h"
 #include "logging.h"
 
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <glob.h>
+#include <libgen.h>
+#include <errno.h>
 #include <time.h>
 #include <endian.h>
+#include <pthread.h>
 
 /* ========================================================================= *
  * CONSTANTS
@@ -54,6 +63,22 @@
  */
 #define EXPECTED_SSU_CONFIG_VERSION 15
 
+/** Path to SSU configuration file */
+#define SSU_CONFIG_PATH         "/etc/ssu/ssu.ini"
+
+/** Directory holding board mapping files */
+#define BOARD_MAPPINGS_DIR      "/usr/share/ssu/board-mappings.d"
+
+/** Glob pattern for locating board mapping files */
+#define BOARD_MAPPINGS_PATTERN  BOARD_MAPPINGS_DIR "/*.ini"
+
+/** Default location of compiled board mappings
+ *
+ * Generated via "ssu-sysinfo --compile-board-mappings" whenever
+ * board mapping files are installed / removed.
+ */
+#define BOARD_MAPPINGS_DB       "/var/cache/ssu-sysinfo/board-mappings.db"
+
 /** Possible paths for OS release data */
 static const char * const os_release_paths[] = {
     "/etc/os-release",
@@ -74,15 +99,132 @@ static const char * const hw_release_paths[] = {
 /** Internal config data section to use for HW release data */
 #define HW_RELEASE_SECTION      "hw-release"
 
+/** Directory holding CSD configuration files */
+#define HW_SETTINGS_DIR         "/usr/share/csd/settings.d"
+
+/** Glob pattern for locating CSD hw feature configuration files */
+#define HW_SETTINGS_PATTERN     HW_SETTINGS_DIR "/*hw-settings*.ini"
+
+/** Default location of resolved values snapshot
+ *
+ * Generated via "ssu-sysinfo --write-snapshot" during bootup and
+ * whenever any of the source files change.
+ */
+#define SNAPSHOT_DB             "/run/ssu-sysinfo/snapshot.db"
+
 /* ========================================================================= *
  * TYPES
  * ========================================================================= */
 
+/** Configuration sources, in load order */
+typedef enum
+{
+    SOURCE_SSU_CONFIG,
+    SOURCE_BOARD_MAPPINGS,
+    SOURCE_RELEASE_INFO,
+    SOURCE_HW_SETTINGS,
+    SOURCE_COUNT
+} ssusysinfo_source_id_t;
+
+/** Stat identity of a file or directory */
+typedef struct
+{
+    char            *path;
+    bool             exists;
+    bool             isdir;
+    dev_t            dev;
+    ino_t            ino;
+    off_t            size;
+    struct timespec  mtime;
+    struct timespec  ctime;
+} ssusysinfo_stamp_t;
+
+/** Content parsed from one configuration source */
+typedef struct
+{
+    inifile_t          *ini;
+    ssusysinfo_stamp_t *stamps; // files and directories the content depends on
+    size_t              count;
+    bool                loaded; // content has been loaded on demand
+} ssusysinfo_source_t;
+
+/** Values derived from configuration data, cached on first use */
+typedef enum
+{
+    CACHED_MODEL,
+    CACHED_BASE_MODEL,
+    CACHED_DESIGNATION,
+    CACHED_MANUFACTURER,
+    CACHED_PRETTY_NAME,
+    CACHED_BOARD_VERSION,
+    CACHED_LAST_CREDENTIALS_UPDATE,
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+    CACHED_CERTIFICATE,
+    CACHED_PRIVATE_KEY,
+#endif
+    CACHED_COUNT
+} ssusysinfo_cached_id_t;
+
+/** Types of device model detection rules, in order of precedence */
+typedef enum
+{
+    MODEL_RULE_FILE_EXISTS,
+    MODEL_RULE_HW_RELEASE,
+    MODEL_RULE_CPUINFO,
+} ssusysinfo_model_rule_kind_t;
+
+/** Device model detection rule */
+typedef struct
+{
+    ssusysinfo_model_rule_kind_t kind;
+    const char                  *value; // path, hw-release key or cpuinfo pattern
+    const char                  *model; // model the rule yields, or NULL;
+                                        // hw-release rules get it when evaluated
+    int                          ord;   // ordinal of board mappings entry
+    int                          id;    // cpuinfo pattern id, or -1
+} ssusysinfo_plan_rule_t;
+
+/** Inotify watch on a directory */
+typedef struct
+{
+    int   wd;
+    char *path;
+} ssusysinfo_watch_t;
+
+/** Immutable set of resolved values, see ssusysinfo_create_threadsafe() */
+typedef struct ssusysinfo_resolved_t ssusysinfo_resolved_t;
+
 /** SSU configuration object structure */
 struct ssusysinfo_t
 {
-    inifile_t *cfg_ini;
-    inifile_t *ssu_ini;
+    ssusysinfo_source_t   source[SOURCE_COUNT];
+    char                 *cached[CACHED_COUNT]; // derived values, or NULL
+    uint64_t              feature_mask;
+    bool                  feature_mask_valid;
+    hw_key_set_t          key_set;
+    bool                  key_set_valid;
+    inidb_t              *snapshot;
+    ssusysinfo_stamp_t    snapshot_stamp;
+    ssusysinfo_stamp_t   *snapshot_deps;
+    size_t                snapshot_dep_count;
+    bool                  loaded;
+    bool                  use_snapshot;
+
+    int                   watch_fd;
+    ssusysinfo_watch_t   *watches;
+    size_t                watch_count;
+    ssusysinfo_change_cb  change_cb;
+    void                 *change_aptr;
+
+    /* Thread safe handles keep configuration data in a private handle
+     * that is accessed only while holding the lock, and serve queries
+     * from immutable resolved values */
+    ssusysinfo_t          *backing;
+    pthread_mutex_t        lock;
+    ssusysinfo_resolved_t *resolved; // current values, published atomically
+    ssusysinfo_resolved_t *retired;  // replaced values, newest first
+    unsigned               epoch;    // reclamation epoch, see ssusysinfo_reclaim()
+    unsigned               readers[2]; // readers in odd / even epochs
 };
 
 /* ========================================================================= *
@@ -92,6 +234,199 @@ struct ssusysinfo_t
 /** Placeholder string value returned whenever value can't be deduced */
 static const char ssusysinfo_unknown[] = "UNKNOWN";
 
+/** Rule names used in ssusysinfo_model_rule_t reports */
+static const char * const ssusysinfo_model_rule_name[] =
+{
+    [MODEL_RULE_FILE_EXISTS] = "file.exists",
+    [MODEL_RULE_HW_RELEASE]  = "hw-release",
+    [MODEL_RULE_CPUINFO]     = "cpuinfo.contains",
+};
+
+/** Snapshot location and dependencies of cached values */
+static const struct
+{
+    const char *sec;     // snapshot section, or NULL if not stored
+    const char *key;     // snapshot key
+    bool        device;  // depends on device model data
+} ssusysinfo_cached_lut[CACHED_COUNT] = {
+    [CACHED_MODEL]                   = { "cached-values", "model",                 true  },
+    [CACHED_BASE_MODEL]              = { "cached-values", "base_model",            true  },
+    [CACHED_DESIGNATION]             = { "cached-attrs",  "deviceDesignation",     true  },
+    [CACHED_MANUFACTURER]            = { "cached-attrs",  "deviceManufacturer",    true  },
+    [CACHED_PRETTY_NAME]             = { "cached-attrs",  "prettyModel",           true  },
+    [CACHED_BOARD_VERSION]           = { "cached-values", "BOARD_VERSION",         true  },
+    [CACHED_LAST_CREDENTIALS_UPDATE] = { "cached-values", "lastCredentialsUpdate", false },
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+    /* Secrets are not included in the world readable snapshot */
+    [CACHED_CERTIFICATE]             = { NULL,            "certificate",           false },
+    [CACHED_PRIVATE_KEY]             = { NULL,            "privateKey",            false },
+#endif
+};
+
+/** Lock for the process wide handle and its reference count */
+static pthread_mutex_t ssusysinfo_global_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Process wide handle, see ssusysinfo_acquire() */
+static ssusysinfo_t *ssusysinfo_global_handle = 0;
+
+/** Number of references to the process wide handle */
+static unsigned ssusysinfo_global_refs = 0;
+
+static const char *ssusysinfo_probe_registered    (ssusysinfo_t *self);
+static const char *ssusysinfo_probe_device_mode   (ssusysinfo_t *self);
+static const char *ssusysinfo_probe_config_version(ssusysinfo_t *self);
+static const char *ssusysinfo_probe_hw_keys       (ssusysinfo_t *self);
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+const char        *ssusysinfo_ssu_credentials_username_jolla(ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_credentials_username_store(ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_credentials_password_jolla(ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_credentials_password_store(ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_certificate               (ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_private_key               (ssusysinfo_t *self);
+#endif
+#if SSU_INCLUDE_UNUSED_ITEMS
+static const char *ssusysinfo_probe_initialized   (ssusysinfo_t *self);
+static const char *ssusysinfo_probe_credentials_ttl(ssusysinfo_t *self);
+const char        *ssusysinfo_ssu_credential_scopes(ssusysinfo_t *self);
+#endif
+
+/** Indices of getters in ssusysinfo_probe_lut */
+typedef enum
+{
+    PROBE_DEVICE_MODEL,
+    PROBE_DEVICE_BASE_MODEL,
+    PROBE_DEVICE_DESIGNATION,
+    PROBE_DEVICE_MANUFACTURER,
+    PROBE_DEVICE_PRETTY_NAME,
+    PROBE_SSU_REGISTERED,
+    PROBE_SSU_DEVICE_MODE,
+    PROBE_SSU_ARCH,
+    PROBE_SSU_BRAND,
+    PROBE_SSU_FLAVOUR,
+    PROBE_SSU_DOMAIN,
+    PROBE_SSU_DEF_RELEASE,
+    PROBE_SSU_RND_RELEASE,
+    PROBE_SSU_ENABLED_REPOS,
+    PROBE_SSU_DISABLED_REPOS,
+    PROBE_SSU_LAST_CREDENTIALS_UPDATE,
+    PROBE_SSU_CREDENTIALS_SCOPE,
+    PROBE_SSU_CREDENTIALS_URL_JOLLA,
+    PROBE_SSU_CREDENTIALS_URL_STORE,
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+    PROBE_SSU_CREDENTIALS_USERNAME_JOLLA,
+    PROBE_SSU_CREDENTIALS_USERNAME_STORE,
+    PROBE_SSU_CREDENTIALS_PASSWORD_JOLLA,
+    PROBE_SSU_CREDENTIALS_PASSWORD_STORE,
+    PROBE_SSU_CERTIFICATE,
+    PROBE_SSU_PRIVATE_KEY,
+#endif
+#if SSU_INCLUDE_UNUSED_ITEMS
+    PROBE_SSU_INITIALIZED,
+    PROBE_SSU_CREDENTIALS_TTL,
+    PROBE_SSU_CREDENTIAL_SCOPES,
+#endif
+    PROBE_SSU_CONFIG_VERSION,
+    PROBE_SSU_DEFAULT_RND_DOMAIN,
+    PROBE_SSU_HOME_URL,
+    PROBE_OS_NAME,
+    PROBE_OS_VERSION,
+    PROBE_OS_PRETTY_VERSION,
+    PROBE_HW_VERSION,
+    PROBE_HW_PRETTY_VERSION,
+    PROBE_HW_KEYS,
+    PROBE_COUNT
+} ssusysinfo_probe_t;
+
+/** Getters whose values make up logical fields in change notifications
+ *
+ * The same values are resolved up front for thread safe handles.
+ */
+static const struct
+{
+    ssusysinfo_field_t   field;
+    const char        *(*get)(ssusysinfo_t *self);
+} ssusysinfo_probe_lut[PROBE_COUNT] = {
+    [PROBE_DEVICE_MODEL]                = { SSUSYSINFO_FIELD_DEVICE_MODEL,     ssusysinfo_device_model },
+    [PROBE_DEVICE_BASE_MODEL]           = { SSUSYSINFO_FIELD_DEVICE_MODEL,     ssusysinfo_device_base_model },
+    [PROBE_DEVICE_DESIGNATION]          = { SSUSYSINFO_FIELD_DEVICE_ATTRS,     ssusysinfo_device_designation },
+    [PROBE_DEVICE_MANUFACTURER]         = { SSUSYSINFO_FIELD_DEVICE_ATTRS,     ssusysinfo_device_manufacturer },
+    [PROBE_DEVICE_PRETTY_NAME]          = { SSUSYSINFO_FIELD_DEVICE_ATTRS,     ssusysinfo_device_pretty_name },
+    [PROBE_SSU_REGISTERED]              = { SSUSYSINFO_FIELD_SSU_REGISTERED,   ssusysinfo_probe_registered },
+    [PROBE_SSU_DEVICE_MODE]             = { SSUSYSINFO_FIELD_SSU_DEVICE_MODE,  ssusysinfo_probe_device_mode },
+    [PROBE_SSU_ARCH]                    = { SSUSYSINFO_FIELD_SSU_ARCH,         ssusysinfo_ssu_arch },
+    [PROBE_SSU_BRAND]                   = { SSUSYSINFO_FIELD_SSU_BRAND,        ssusysinfo_ssu_brand },
+    [PROBE_SSU_FLAVOUR]                 = { SSUSYSINFO_FIELD_SSU_FLAVOUR,      ssusysinfo_ssu_flavour },
+    [PROBE_SSU_DOMAIN]                  = { SSUSYSINFO_FIELD_SSU_DOMAIN,       ssusysinfo_ssu_domain },
+    [PROBE_SSU_DEF_RELEASE]             = { SSUSYSINFO_FIELD_SSU_RELEASE,      ssusysinfo_ssu_def_release },
+    [PROBE_SSU_RND_RELEASE]             = { SSUSYSINFO_FIELD_SSU_RELEASE,      ssusysinfo_ssu_rnd_release },
+    [PROBE_SSU_ENABLED_REPOS]           = { SSUSYSINFO_FIELD_SSU_REPOS,        ssusysinfo_ssu_enabled_repos },
+    [PROBE_SSU_DISABLED_REPOS]          = { SSUSYSINFO_FIELD_SSU_REPOS,        ssusysinfo_ssu_disabled_repos },
+    [PROBE_SSU_LAST_CREDENTIALS_UPDATE] = { SSUSYSINFO_FIELD_SSU_CREDENTIALS,  ssusysinfo_ssu_last_credentials_update },
+    [PROBE_SSU_CREDENTIALS_SCOPE]       = { SSUSYSINFO_FIELD_SSU_CREDENTIALS,  ssusysinfo_ssu_credentials_scope },
+    [PROBE_SSU_CREDENTIALS_URL_JOLLA]   = { SSUSYSINFO_FIELD_SSU_CREDENTIALS,  ssusysinfo_ssu_credentials_url_jolla },
+    [PROBE_SSU_CREDENTIALS_URL_STORE]   = { SSUSYSINFO_FIELD_SSU_CREDENTIALS,  ssusysinfo_ssu_credentials_url_store },
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+    [PROBE_SSU_CREDENTIALS_USERNAME_JOLLA] = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_credentials_username_jolla },
+    [PROBE_SSU_CREDENTIALS_USERNAME_STORE] = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_credentials_username_store },
+    [PROBE_SSU_CREDENTIALS_PASSWORD_JOLLA] = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_credentials_password_jolla },
+    [PROBE_SSU_CREDENTIALS_PASSWORD_STORE] = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_credentials_password_store },
+    [PROBE_SSU_CERTIFICATE]                = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_certificate },
+    [PROBE_SSU_PRIVATE_KEY]                = { SSUSYSINFO_FIELD_SSU_CREDENTIALS, ssusysinfo_ssu_private_key },
+#endif
+#if SSU_INCLUDE_UNUSED_ITEMS
+    [PROBE_SSU_INITIALIZED]             = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_probe_initialized },
+    [PROBE_SSU_CREDENTIALS_TTL]         = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_probe_credentials_ttl },
+    [PROBE_SSU_CREDENTIAL_SCOPES]       = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_ssu_credential_scopes },
+#endif
+    [PROBE_SSU_CONFIG_VERSION]          = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_probe_config_version },
+    [PROBE_SSU_DEFAULT_RND_DOMAIN]      = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_ssu_default_rnd_domain },
+    [PROBE_SSU_HOME_URL]                = { SSUSYSINFO_FIELD_SSU_OTHER,        ssusysinfo_ssu_home_url },
+    [PROBE_OS_NAME]                     = { SSUSYSINFO_FIELD_OS_RELEASE,       ssusysinfo_os_name },
+    [PROBE_OS_VERSION]                  = { SSUSYSINFO_FIELD_OS_RELEASE,       ssusysinfo_os_version },
+    [PROBE_OS_PRETTY_VERSION]           = { SSUSYSINFO_FIELD_OS_RELEASE,       ssusysinfo_os_pretty_version },
+    [PROBE_HW_VERSION]                  = { SSUSYSINFO_FIELD_HW_RELEASE,       ssusysinfo_hw_version },
+    [PROBE_HW_PRETTY_VERSION]           = { SSUSYSINFO_FIELD_HW_RELEASE,       ssusysinfo_hw_pretty_version },
+    [PROBE_HW_KEYS]                     = { SSUSYSINFO_FIELD_HW_KEYS,          ssusysinfo_probe_hw_keys },
+};
+
+/** Values of logical fields at some point of time */
+typedef struct
+{
+    char     *values[PROBE_COUNT];
+    uint64_t  features;   // mask of supported hw features
+} ssusysinfo_fields_t;
+
+/** Immutable resolved values
+ *
+ * Once published, content is not modified, and the object is not
+ * released while there are readers that might be using it.
+ */
+struct ssusysinfo_resolved_t
+{
+    ssusysinfo_resolved_t *retired;       // next older set of values
+    unsigned               epoch;         // epoch at which values were replaced
+    ssusysinfo_fields_t    fields;
+    char                  *board_version;
+    hw_key_set_t           keys;
+    bool                   keys_configured; // [Keys] Keys entry exists
+    bool                   moved[PROBE_COUNT]; // value owned by newer set
+    bool                   board_moved;
+};
+
+/** Number of handles a thread can have open read sections on at once */
+#define SSUSYSINFO_MAX_PINS 4
+
+/** Resolved values pinned by a read section of the current thread */
+typedef struct
+{
+    const ssusysinfo_t          *handle;   // handle, or NULL for unused slot
+    const ssusysinfo_resolved_t *resolved; // values seen at read section start
+    unsigned                     depth;    // number of nested read sections
+} ssusysinfo_pin_t;
+
+/** Resolved values pinned by read sections of the current thread */
+static __thread ssusysinfo_pin_t ssusysinfo_pins[SSUSYSINFO_MAX_PINS];
+
 /* ========================================================================= *
  * PROTOTYPES
  * ========================================================================= */
@@ -104,28 +439,96 @@ static char       *qtdecoder_parse_datetime                 (const char *txt);
 static char       *qtdecoder_parse_bytearray                (const char *txt, size_t *psize);
 #endif
 
+static void        ssusysinfo_stamp_probe                   (ssusysinfo_stamp_t *self);
+static void        ssusysinfo_stamp_ctor                    (ssusysinfo_stamp_t *self, const char *path);
+static void        ssusysinfo_stamp_dtor                    (ssusysinfo_stamp_t *self);
+static bool        ssusysinfo_stamp_changed                 (const ssusysinfo_stamp_t *self);
+static bool        ssusysinfo_stamp_matches                 (const ssusysinfo_stamp_t *self, const char *dir, const char *name);
+
+static void        ssusysinfo_source_ctor                   (ssusysinfo_source_t *self);
+static void        ssusysinfo_source_dtor                   (ssusysinfo_source_t *self);
+static void        ssusysinfo_source_reset                  (ssusysinfo_source_t *self);
+static const ssusysinfo_stamp_t *ssusysinfo_source_track    (ssusysinfo_source_t *self, const char *path);
+static bool        ssusysinfo_source_changed                (const ssusysinfo_source_t *self);
+
+static void        ssusysinfo_fields_capture                (ssusysinfo_t *self, ssusysinfo_fields_t *fields);
+static void        ssusysinfo_fields_release                (ssusysinfo_fields_t *fields);
+static unsigned    ssusysinfo_fields_diff                   (const ssusysinfo_fields_t *prev, const ssusysinfo_fields_t *curr);
+
+static bool        ssusysinfo_is_shared                     (const ssusysinfo_t *self);
+static ssusysinfo_resolved_t *ssusysinfo_resolved_create     (ssusysinfo_t *backing);
+static void        ssusysinfo_resolved_delete               (ssusysinfo_resolved_t *res);
+static void        ssusysinfo_publish                       (ssusysinfo_t *self);
+static void        ssusysinfo_reclaim                       (ssusysinfo_t *self);
+static const ssusysinfo_resolved_t *ssusysinfo_resolved_current(ssusysinfo_t *self);
+static ssusysinfo_pin_t *ssusysinfo_pin_find                (const ssusysinfo_t *self);
+static const ssusysinfo_resolved_t *ssusysinfo_resolved      (ssusysinfo_t *self);
+static const char *ssusysinfo_shared_value                  (ssusysinfo_t *self, ssusysinfo_probe_t id);
+
+static void        ssusysinfo_watch_add                     (ssusysinfo_t *self, const char *path, ssusysinfo_watch_t *watches, size_t *pcount);
+static void        ssusysinfo_watch_stamp                   (ssusysinfo_t *self, const ssusysinfo_stamp_t *stamp, ssusysinfo_watch_t *watches, size_t *pcount);
+static void        ssusysinfo_watch_snapshot_deps           (ssusysinfo_t *self);
+static void        ssusysinfo_watch_update                  (ssusysinfo_t *self);
+static void        ssusysinfo_watch_close                   (ssusysinfo_t *self);
+static bool        ssusysinfo_watch_relevant                (const ssusysinfo_t *self, const struct inotify_event *eve);
+static size_t      ssusysinfo_watch_needed                  (const ssusysinfo_t *self);
+
+static const char *ssusysinfo_cache_set                     (ssusysinfo_t *self, ssusysinfo_cached_id_t id, const char *value);
+static void        ssusysinfo_cache_forget                  (ssusysinfo_t *self, bool device);
+static void        ssusysinfo_cache_import                  (ssusysinfo_t *self, const inidb_t *db);
+
 static void        ssusysinfo_ctor                          (ssusysinfo_t *self);
 static void        ssusysinfo_dtor                          (ssusysinfo_t *self);
 ssusysinfo_t      *ssusysinfo_create                        (void);
+ssusysinfo_t      *ssusysinfo_create_threadsafe             (void);
 void               ssusysinfo_delete                        (ssusysinfo_t *self);
 void               ssusysinfo_delete_cb                     (void *self);
-
+ssusysinfo_t      *ssusysinfo_acquire                       (void);
+void               ssusysinfo_release                       (ssusysinfo_t *self);
+static bool        ssusysinfo_release_global                (ssusysinfo_t *self);
+static inifile_t   *ssusysinfo_source_ini                    (ssusysinfo_t *self, ssusysinfo_source_id_t id);
+static const char *ssusysinfo_cfg_get                       (ssusysinfo_t *self, const char *sec, const char *key);
+static const char *ssusysinfo_release_get                   (ssusysinfo_t *self, const char *sec, const char *key);
+static inisec_t   *ssusysinfo_board_section                 (ssusysinfo_t *self, const char *sec);
+static uint64_t    ssusysinfo_evaluate_feature_mask         (ssusysinfo_t *self);
+static const hw_key_set_t *ssusysinfo_hw_key_set            (ssusysinfo_t *self);
+
+static void        ssusysinfo_add_sources                   (glob_t *gl, const char *pattern, int flags);
+static inidb_stamp_t *ssusysinfo_stamp_sources              (inidb_stamp_t *stamps, const glob_t *gl, size_t first);
+static void        ssusysinfo_parse_board_mappings          (inifile_t *ini, glob_t *gl, ssusysinfo_source_t *src);
 static void        ssusysinfo_load_board_mappings           (ssusysinfo_t *self);
 static void        ssusysinfo_load_release_file             (ssusysinfo_t *self, const char * const *paths, const char *section);
 static void        ssusysinfo_load_release_info             (ssusysinfo_t *self);
 static void        ssusysinfo_load_hw_settings              (ssusysinfo_t *self);
 static void        ssusysinfo_load_ssu_config               (ssusysinfo_t *self);
+static bool        ssusysinfo_load_snapshot                 (ssusysinfo_t *self);
+static int         ssusysinfo_copy_section_cmp              (const void *a, const void *b);
+static void        ssusysinfo_copy_section                  (inifile_t *dst, inifile_t *src, const char *name, const char * const *skip);
+static void        ssusysinfo_load_source                   (ssusysinfo_t *self, ssusysinfo_source_id_t id);
 
 static void        ssusysinfo_load                          (ssusysinfo_t *self);
 static void        ssusysinfo_unload                        (ssusysinfo_t *self);
 void               ssusysinfo_reload                        (ssusysinfo_t *self);
-
-static const char *ssusysinfo_device_model_from_cpuinfo     (ssusysinfo_t *self);
-static const char *ssusysinfo_device_model_from_flagfiles   (ssusysinfo_t *self);
-static const char *ssusysinfo_device_model_from_hw_release  (ssusysinfo_t *self);
+static bool        ssusysinfo_refresh_sources               (ssusysinfo_t *self);
+void               ssusysinfo_refresh                       (ssusysinfo_t *self);
+int                ssusysinfo_get_watch_fd                  (ssusysinfo_t *self);
+unsigned           ssusysinfo_process_events                (ssusysinfo_t *self);
+void               ssusysinfo_set_change_cb                 (ssusysinfo_t *self, ssusysinfo_change_cb cb, void *aptr);
+unsigned           ssusysinfo_read_begin                    (ssusysinfo_t *self);
+void               ssusysinfo_read_end                      (ssusysinfo_t *self, unsigned token);
+bool               ssusysinfo_compile_board_mappings        (const char *path);
+bool               ssusysinfo_write_snapshot                (const char *path);
+int                ssusysinfo_scan_ini                      (const char *path, const char *defsec, ssusysinfo_ini_cb cb, void *aptr);
+
+static size_t      ssusysinfo_model_plan_section            (inisec_t *sec, ssusysinfo_model_rule_kind_t kind, ssusysinfo_plan_rule_t *plan, size_t used);
+static ssusysinfo_plan_rule_t *ssusysinfo_model_plan        (ssusysinfo_t *self, size_t *pcount);
+static int         ssusysinfo_model_scan_cpuinfo            (const ssusysinfo_plan_rule_t *rules, size_t count);
+static uint64_t    ssusysinfo_model_clock                   (void);
+static const char *ssusysinfo_device_model_detect           (ssusysinfo_t *self, ssusysinfo_model_rule_cb cb, void *aptr);
 const char        *ssusysinfo_device_model                  (ssusysinfo_t *self);
+void               ssusysinfo_explain_device_model          (ssusysinfo_t *self, ssusysinfo_model_rule_cb cb, void *aptr);
 
-static const char *ssusysinfo_device_attr                   (ssusysinfo_t *self, const char *key);
+static const char *ssusysinfo_device_attr                   (ssusysinfo_t *self, ssusysinfo_cached_id_t id);
 const char        *ssusysinfo_device_designation            (ssusysinfo_t *self);
 const char        *ssusysinfo_device_manufacturer           (ssusysinfo_t *self);
 const char        *ssusysinfo_device_pretty_name            (ssusysinfo_t *self);
@@ -505,353 +908,2169 @@ EXIT:
 #endif /* SSU_INCLUDE_CREDENTIAL_ITEMS */
 
 /* ------------------------------------------------------------------------- *
- * Internal Functions
+ * Source Tracking
  * ------------------------------------------------------------------------- */
 
-/** Initialize freshly allocated configuration object to safe defaults
+/** Update stat identity of a path
  *
- * @param self ssusysinfo object pointer
+ * @param self stamp object pointer
  */
 static void
-ssusysinfo_ctor(ssusysinfo_t *self)
+ssusysinfo_stamp_probe(ssusysinfo_stamp_t *self)
 {
-    self->cfg_ini = 0;
-    self->ssu_ini = 0;
+    struct stat st;
+
+    *self = (ssusysinfo_stamp_t){ .path = self->path };
+
+    if( stat(self->path, &st) == -1 )
+        return;
+
+    self->exists = true;
+    self->isdir  = S_ISDIR(st.st_mode);
+    self->dev    = st.st_dev;
+    self->ino    = st.st_ino;
+    self->size   = st.st_size;
+    self->mtime  = st.st_mtim;
+    self->ctime  = st.st_ctim;
 }
 
-/** Release dynamic resources held by initialized  configuration object
+/** Initialize stamp with current stat identity of a path
  *
- * @param self ssusysinfo object pointer
+ * @param self stamp object pointer
+ * @param path file or directory path
  */
 static void
-ssusysinfo_dtor(ssusysinfo_t *self)
+ssusysinfo_stamp_ctor(ssusysinfo_stamp_t *self, const char *path)
 {
-    ssusysinfo_unload(self);
+    self->path = xstrdup(path);
+    ssusysinfo_stamp_probe(self);
 }
 
-/** Load board mapping configuration files
+/** Release dynamic resources held by a stamp
  *
- * @param self ssusysinfo object pointer
+ * @param self stamp object pointer
  */
 static void
-ssusysinfo_load_board_mappings(ssusysinfo_t *self)
+ssusysinfo_stamp_dtor(ssusysinfo_stamp_t *self)
 {
-    glob_t gl = {};
+    free(self->path);
+    *self = (ssusysinfo_stamp_t){ .path = 0 };
+}
 
-    if( glob("/usr/share/ssu/board-mappings.d/*.ini", 0, 0, &gl) == 0 ) {
-        for( size_t i = 0; i < gl.gl_pathc; ++i )
-            inifile_load(self->cfg_ini, gl.gl_pathv[i], 0);
-    }
+/** Check whether path has changed since it was stamped
+ *
+ * @param self stamp object pointer
+ *
+ * @return true if the path has been created, removed or modified
+ */
+static bool
+ssusysinfo_stamp_changed(const ssusysinfo_stamp_t *self)
+{
+    ssusysinfo_stamp_t now = { .path = self->path };
 
-    globfree(&gl);
+    ssusysinfo_stamp_probe(&now);
+
+    if( now.exists != self->exists )
+        return true;
+
+    if( !now.exists )
+        return false;
+
+    return (now.dev           != self->dev           ||
+            now.ino           != self->ino           ||
+            now.size          != self->size          ||
+            now.mtime.tv_sec  != self->mtime.tv_sec  ||
+            now.mtime.tv_nsec != self->mtime.tv_nsec ||
+            now.ctime.tv_sec  != self->ctime.tv_sec  ||
+            now.ctime.tv_nsec != self->ctime.tv_nsec);
 }
 
-/** Load release information from list of possible file paths
+/** Check whether directory entry is tracked via stamp
  *
- * @param self     ssusysinfo object pointer
- * @param paths    array of altrernate paths to try
- * @param section  config section in which to store loaded data
+ * @param self stamp object pointer
+ * @param dir  directory path
+ * @param name entry name within the directory
+ *
+ * @return true if the stamp is for the entry, or for the directory
+ */
+static bool
+ssusysinfo_stamp_matches(const ssusysinfo_stamp_t *self, const char *dir,
+                         const char *name)
+{
+    const char *path = self->path;
+    size_t      len  = strlen(dir);
+
+    if( !path )
+        return false;
+
+    if( self->isdir && !strcmp(path, dir) )
+        return true;
+
+    /* Root directory has no separator after it */
+    if( len == 1 )
+        len = 0;
+
+    return (!strncmp(path, dir, len) && path[len] == '/' &&
+            !strcmp(path + len + 1, name));
+}
+
+/** Initialize configuration source
+ *
+ * @param self source object pointer
  */
 static void
-ssusysinfo_load_release_file(ssusysinfo_t *self, const char * const *paths,
-                             const char *section)
+ssusysinfo_source_ctor(ssusysinfo_source_t *self)
 {
-    for( ;; ) {
-        const char *path = *paths++;
-        if( !path ) {
-            log_warning("%s data not found", section);
-            break;
-        }
-        if( access(path, F_OK) == -1 )
-            continue;
-        /* Note: The first existing alternative is used, regardless
-         *       of whether it can be successfully parsed or not. */
-        inifile_load(self->cfg_ini, path, section);
-        break;
-    }
+    self->ini    = inifile_create();
+    self->stamps = 0;
+    self->count  = 0;
+    self->loaded = false;
 }
 
-/** Load release information configuration files
+/** Release dynamic resources held by configuration source
  *
- * @param self ssusysinfo object pointer
+ * @param self source object pointer
  */
 static void
-ssusysinfo_load_release_info(ssusysinfo_t *self)
+ssusysinfo_source_dtor(ssusysinfo_source_t *self)
 {
-    ssusysinfo_load_release_file(self, hw_release_paths, HW_RELEASE_SECTION);
-    ssusysinfo_load_release_file(self, os_release_paths, OS_RELEASE_SECTION);
+    ssusysinfo_source_reset(self);
+
+    inifile_delete(self->ini),
+        self->ini = 0;
 }
 
-/** Load CSD hw feature configuration files
+/** Drop loaded content and tracked paths of configuration source
  *
- * @param self ssusysinfo object pointer
+ * @param self source object pointer
  */
 static void
-ssusysinfo_load_hw_settings(ssusysinfo_t *self)
+ssusysinfo_source_reset(ssusysinfo_source_t *self)
 {
-    glob_t gl = {};
+    for( size_t i = 0; i < self->count; ++i )
+        ssusysinfo_stamp_dtor(&self->stamps[i]);
 
-    if (glob("/usr/share/csd/settings.d/*hw-settings*.ini", 0, 0, &gl) == 0) {
-        for (size_t i = 0; i < gl.gl_pathc; ++i)
-            inifile_load(self->cfg_ini, gl.gl_pathv[i], 0);
+    free(self->stamps),
+        self->stamps = 0, self->count = 0;
+
+    inifile_reset(self->ini);
+}
+
+/** Add path that configuration source content depends on
+ *
+ * Paths should be tracked before they are read, so that changes
+ * made while loading do not go unnoticed.
+ *
+ * @param self source object pointer
+ * @param path file or directory path
+ *
+ * @return stamp describing current state of the path
+ */
+static const ssusysinfo_stamp_t *
+ssusysinfo_source_track(ssusysinfo_source_t *self, const char *path)
+{
+    self->stamps = xrealloc(self->stamps,
+                            (self->count + 1) * sizeof *self->stamps);
+
+    ssusysinfo_stamp_t *stamp = &self->stamps[self->count++];
+    ssusysinfo_stamp_ctor(stamp, path);
+    return stamp;
+}
+
+/** Check whether any tracked path has changed
+ *
+ * @param self source object pointer
+ *
+ * @return true if source needs to be reloaded, false otherwise
+ */
+static bool
+ssusysinfo_source_changed(const ssusysinfo_source_t *self)
+{
+    for( size_t i = 0; i < self->count; ++i ) {
+        if( ssusysinfo_stamp_changed(&self->stamps[i]) )
+            return true;
     }
+    return false;
+}
 
-    globfree(&gl);
+/* ------------------------------------------------------------------------- *
+ * Change Tracking
+ * ------------------------------------------------------------------------- */
+
+static const char *
+ssusysinfo_probe_registered(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_REGISTERED);
+
+    return ssusysinfo_ssu_attr(self, "registered");
 }
 
-/** Load SSU configuration files
+static const char *
+ssusysinfo_probe_device_mode(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_DEVICE_MODE);
+
+    return ssusysinfo_ssu_attr(self, "deviceMode");
+}
+
+static const char *
+ssusysinfo_probe_config_version(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CONFIG_VERSION);
+
+    return ssusysinfo_ssu_attr(self, "configVersion");
+}
+
+static const char *
+ssusysinfo_probe_hw_keys(ssusysinfo_t *self)
+{
+    return ssusysinfo_cfg_get(self, "Keys", "Keys") ?: "";
+}
+
+#if SSU_INCLUDE_UNUSED_ITEMS
+static const char *
+ssusysinfo_probe_initialized(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_INITIALIZED);
+
+    return ssusysinfo_ssu_attr(self, "initialized");
+}
+
+static const char *
+ssusysinfo_probe_credentials_ttl(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_TTL);
+
+    return ssusysinfo_ssu_attr(self, "credentials-ttl");
+}
+#endif
+
+/** Make a copy of current logical field values
  *
- * @param self ssusysinfo object pointer
+ * @param self    ssusysinfo object pointer
+ * @param fields  where to store the values
  */
 static void
-ssusysinfo_load_ssu_config(ssusysinfo_t *self)
+ssusysinfo_fields_capture(ssusysinfo_t *self, ssusysinfo_fields_t *fields)
 {
-    inifile_load(self->ssu_ini, "/etc/ssu/ssu.ini", 0);
+    for( size_t i = 0; i < PROBE_COUNT; ++i )
+        fields->values[i] = xstrdup(ssusysinfo_probe_lut[i].get(self));
 
-    int version_want = EXPECTED_SSU_CONFIG_VERSION;
-    int version_have = ssusysinfo_ssu_config_version(self);
-    if( version_have != version_want ) {
-        log_warning("expected ssu config version %d, found %d",
-                    version_want, version_have);
-    }
+    fields->features = ssusysinfo_hw_feature_mask(self);
 }
 
-/** Load all SSU configuration files
+/** Release dynamic resources held by captured field values
  *
- * @param self ssusysinfo object pointer
+ * @param fields  captured values
  */
 static void
-ssusysinfo_load(ssusysinfo_t *self)
+ssusysinfo_fields_release(ssusysinfo_fields_t *fields)
 {
-    if( !self )
-        goto EXIT;
+    for( size_t i = 0; i < PROBE_COUNT; ++i )
+        free(fields->values[i]), fields->values[i] = 0;
+}
 
-    if( self->cfg_ini )
-        goto EXIT;
+/** Compare captured field values
+ *
+ * @param prev  values before reload
+ * @param curr  values after reload
+ *
+ * @return bitmask of changed #ssusysinfo_field_t values
+ */
+static unsigned
+ssusysinfo_fields_diff(const ssusysinfo_fields_t *prev,
+                       const ssusysinfo_fields_t *curr)
+{
+    unsigned changed = 0;
+
+    for( size_t i = 0; i < PROBE_COUNT; ++i ) {
+        if( strcmp(prev->values[i], curr->values[i]) )
+            changed |= ssusysinfo_probe_lut[i].field;
+    }
 
-    self->cfg_ini = inifile_create();
-    self->ssu_ini = inifile_create();
+    if( prev->features != curr->features )
+        changed |= SSUSYSINFO_FIELD_HW_FEATURES;
 
-    ssusysinfo_load_ssu_config(self);
-    ssusysinfo_load_board_mappings(self);
-    ssusysinfo_load_release_info(self);
-    ssusysinfo_load_hw_settings(self);
+    return changed;
+}
 
-#if 0 /* for devel time debugging */
-    inifile_dump(self->cfg_ini);
-    inifile_dump(self->ssu_ini);
-#endif
+/* ------------------------------------------------------------------------- *
+ * Thread Safe Handles
+ * ------------------------------------------------------------------------- */
 
-EXIT:
-    return;
+/** Check whether object is a handle created for sharing between threads
+ *
+ * @param self ssusysinfo object pointer, or NULL
+ *
+ * @return true for thread safe handles, false otherwise
+ */
+static bool
+ssusysinfo_is_shared(const ssusysinfo_t *self)
+{
+    return self && self->backing;
 }
 
-/** Unload all values from SSU configuration files
+/** Resolve all values from a private handle
+ *
+ * @param backing ssusysinfo object pointer
+ *
+ * @return resolved values object
+ */
+static ssusysinfo_resolved_t *
+ssusysinfo_resolved_create(ssusysinfo_t *backing)
+{
+    ssusysinfo_resolved_t *res = xcalloc(1, sizeof *res);
+
+    ssusysinfo_fields_capture(backing, &res->fields);
+    res->board_version = xstrdup(ssusysinfo_board_version(backing));
+    hw_key_set_parse(&res->keys, res->fields.values[PROBE_HW_KEYS]);
+    res->keys_configured = ssusysinfo_cfg_get(backing, "Keys", "Keys") != 0;
+
+    return res;
+}
+
+/** Release resolved values object
+ *
+ * @param res resolved values object, or NULL
+ */
+static void
+ssusysinfo_resolved_delete(ssusysinfo_resolved_t *res)
+{
+    if( res ) {
+        for( size_t i = 0; i < PROBE_COUNT; ++i ) {
+            if( !res->moved[i] )
+                free(res->fields.values[i]);
+        }
+        if( !res->board_moved )
+            free(res->board_version);
+        hw_key_set_clear(&res->keys);
+        free(res);
+    }
+}
+
+/** Resolve values from the private handle and make them available to readers
+ *
+ * Must be called while holding the lock. Values that are replaced are
+ * retired, and released only after readers that might be using them
+ * have left their read sections.
+ *
+ * Strings that did not change are carried over to the new set of
+ * values, so that strings obtained outside read sections stay valid
+ * until the value itself changes.
  *
  * @param self ssusysinfo object pointer
  */
 static void
-ssusysinfo_unload(ssusysinfo_t *self)
+ssusysinfo_publish(ssusysinfo_t *self)
 {
-    inifile_delete(self->ssu_ini),
-        self->ssu_ini = 0;
+    ssusysinfo_resolved_t *prev = self->resolved;
+    ssusysinfo_resolved_t *curr = ssusysinfo_resolved_create(self->backing);
+
+    if( prev ) {
+        if( !ssusysinfo_fields_diff(&prev->fields, &curr->fields) &&
+            !strcmp(prev->board_version, curr->board_version) &&
+            prev->keys_configured == curr->keys_configured ) {
+            ssusysinfo_resolved_delete(curr);
+            goto EXIT;
+        }
+    }
+
+    if( prev ) {
+        for( size_t i = 0; i < PROBE_COUNT; ++i ) {
+            if( !strcmp(prev->fields.values[i], curr->fields.values[i]) ) {
+                free(curr->fields.values[i]);
+                curr->fields.values[i] = prev->fields.values[i];
+                prev->moved[i] = true;
+            }
+        }
+        if( !strcmp(prev->board_version, curr->board_version) ) {
+            free(curr->board_version);
+            curr->board_version = prev->board_version;
+            prev->board_moved = true;
+        }
+    }
 
-    inifile_delete(self->cfg_ini),
-        self->cfg_ini = 0;
+    __atomic_store_n(&self->resolved, curr, __ATOMIC_RELEASE);
+
+    if( prev ) {
+        prev->epoch   = self->epoch;
+        prev->retired = self->retired;
+        __atomic_store_n(&self->retired, prev, __ATOMIC_RELEASE);
+    }
+
+EXIT:
+    ssusysinfo_reclaim(self);
 }
 
-/** Try to determine device model based on cpuinfo and config file data
+/** Release retired values that can't be in use anymore
  *
- * @param self ssusysinfo object pointer
+ * Must be called while holding the lock.
  *
- * @return c-string, or NULL in case model can't be determined
+ * Readers register to the counter of the epoch that is current when
+ * they enter a read section. The epoch is advanced only after readers
+ * of the epoch before the current one have left, so values retired
+ * during epoch N are unreachable once epoch N+2 has been reached.
+ *
+ * Never waits for readers - values that are still in use are
+ * released later on.
+ *
+ * @param self ssusysinfo object pointer
  */
-static const char *
-ssusysinfo_device_model_from_cpuinfo(ssusysinfo_t *self)
+static void
+ssusysinfo_reclaim(ssusysinfo_t *self)
 {
-    inival_t   *res  = 0;
-    inisec_t   *sec  = 0;
-    const char *path = "/proc/cpuinfo";
-    char       *text = 0;
-
-    if( !self || !self->cfg_ini )
+    if( !self->retired )
         goto EXIT;
 
-    if( !(sec = inifile_get_section(self->cfg_ini, "cpuinfo.contains")) )
-        goto EXIT;
+    for( int i = 0; i < 2; ++i ) {
+        unsigned epoch = self->epoch;
+        if( __atomic_load_n(&self->readers[(epoch + 1) & 1], __ATOMIC_SEQ_CST) )
+            break;
+        __atomic_store_n(&self->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+    }
+
+    /* Retired list is ordered from newest to oldest */
+    ssusysinfo_resolved_t **tail = &self->retired;
+    while( *tail && self->epoch - (*tail)->epoch < 2 )
+        tail = &(*tail)->retired;
 
-    if( !(text = fileutil_read(path, 0)) )
+    ssusysinfo_resolved_t *res = *tail;
+    __atomic_store_n(tail, 0, __ATOMIC_RELEASE);
+
+    while( res ) {
+        ssusysinfo_resolved_t *next = res->retired;
+        ssusysinfo_resolved_delete(res);
+        res = next;
+    }
+
+EXIT:
+    return;
+}
+
+/** Get most recently published values of thread safe handle
+ *
+ * Must be called within a read section. Values are resolved on first
+ * use, after which the lookup is just an atomic pointer load.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return resolved values object
+ */
+static const ssusysinfo_resolved_t *
+ssusysinfo_resolved_current(ssusysinfo_t *self)
+{
+    ssusysinfo_resolved_t *res = __atomic_load_n(&self->resolved,
+                                                 __ATOMIC_ACQUIRE);
+    if( !res ) {
+        pthread_mutex_lock(&self->lock);
+        if( !self->resolved )
+            ssusysinfo_publish(self);
+        res = self->resolved;
+        pthread_mutex_unlock(&self->lock);
+    }
+
+    return res;
+}
+
+/** Find read section pin of the current thread
+ *
+ * @param self ssusysinfo object pointer, or NULL to find an unused slot
+ *
+ * @return pin, or NULL if not found
+ */
+static ssusysinfo_pin_t *
+ssusysinfo_pin_find(const ssusysinfo_t *self)
+{
+    for( size_t i = 0; i < SSUSYSINFO_MAX_PINS; ++i ) {
+        if( ssusysinfo_pins[i].handle == self )
+            return &ssusysinfo_pins[i];
+    }
+    return 0;
+}
+
+/** Get resolved values of thread safe handle
+ *
+ * Must be called within a read section. All queries made within the
+ * outermost read section see the values that were current when the
+ * section was entered.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return resolved values object
+ */
+static const ssusysinfo_resolved_t *
+ssusysinfo_resolved(ssusysinfo_t *self)
+{
+    const ssusysinfo_pin_t *pin = ssusysinfo_pin_find(self);
+
+    return pin ? pin->resolved : ssusysinfo_resolved_current(self);
+}
+
+/** Get resolved getter value of thread safe handle
+ *
+ * @param self ssusysinfo object pointer
+ * @param id   getter index
+ *
+ * @return c-string
+ */
+static const char *
+ssusysinfo_shared_value(ssusysinfo_t *self, ssusysinfo_probe_t id)
+{
+    unsigned    token = ssusysinfo_read_begin(self);
+    const char *value = ssusysinfo_resolved(self)->fields.values[id];
+    ssusysinfo_read_end(self, token);
+    return value;
+}
+
+/** Add inotify watch for a directory, unless it is already in the list
+ *
+ * @param self     ssusysinfo object pointer
+ * @param path     directory path
+ * @param watches  array of watches to append to
+ * @param pcount   number of watches in the array
+ */
+static void
+ssusysinfo_watch_add(ssusysinfo_t *self, const char *path,
+                     ssusysinfo_watch_t *watches, size_t *pcount)
+{
+    const uint32_t mask = (IN_CLOSE_WRITE | IN_ATTRIB |
+                           IN_CREATE | IN_DELETE |
+                           IN_MOVED_FROM | IN_MOVED_TO |
+                           IN_DELETE_SELF | IN_MOVE_SELF |
+                           IN_ONLYDIR);
+
+    /* Adding the same directory again yields the same descriptor */
+    int wd = inotify_add_watch(self->watch_fd, path, mask);
+    if( wd == -1 ) {
+        if( errno != ENOENT )
+            log_warning("%s: inotify_add_watch: %m", path);
+        return;
+    }
+
+    for( size_t i = 0; i < *pcount; ++i ) {
+        if( watches[i].wd == wd )
+            return;
+    }
+
+    watches[*pcount].wd   = wd;
+    watches[*pcount].path = xstrdup(path);
+    ++*pcount;
+}
+
+/** Add inotify watch for a tracked path
+ *
+ * Directories are watched directly. For files, the parent directory
+ * is watched, so that also replacing files via rename is noticed.
+ */
+static void
+ssusysinfo_watch_stamp(ssusysinfo_t *self, const ssusysinfo_stamp_t *stamp,
+                       ssusysinfo_watch_t *watches, size_t *pcount)
+{
+    if( stamp->exists && stamp->isdir ) {
+        ssusysinfo_watch_add(self, stamp->path, watches, pcount);
+    }
+    else {
+        char *temp = xstrdup(stamp->path);
+        ssusysinfo_watch_add(self, dirname(temp), watches, pcount);
+        free(temp);
+    }
+}
+
+/** Upper limit for number of watches needed for tracked paths
+ */
+static size_t
+ssusysinfo_watch_needed(const ssusysinfo_t *self)
+{
+    size_t count = 1 + self->snapshot_dep_count;
+    for( size_t id = 0; id < SOURCE_COUNT; ++id )
+        count += self->source[id].count;
+    return count;
+}
+
+/** Track files the snapshot in use was generated from
+ *
+ * Changes to sources are handled by checking whether the snapshot is
+ * still up to date, but watches are needed to get notified about them
+ * without waiting for the snapshot to be regenerated.
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_watch_snapshot_deps(ssusysinfo_t *self)
+{
+    if( !self->snapshot || self->snapshot_deps )
+        goto EXIT;
+
+    size_t count = inidb_source_count(self->snapshot);
+
+    self->snapshot_deps = xcalloc(count ?: 1, sizeof *self->snapshot_deps);
+    self->snapshot_dep_count = count;
+
+    for( size_t i = 0; i < count; ++i )
+        ssusysinfo_stamp_ctor(&self->snapshot_deps[i],
+                              inidb_source_path(self->snapshot, i));
+
+EXIT:
+    return;
+}
+
+/** Synchronize inotify watches with currently tracked paths
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_watch_update(ssusysinfo_t *self)
+{
+    if( self->watch_fd == -1 )
+        goto EXIT;
+
+    ssusysinfo_watch_snapshot_deps(self);
+
+    ssusysinfo_watch_t *watches = xcalloc(ssusysinfo_watch_needed(self),
+                                          sizeof *watches);
+    size_t              count   = 0;
+
+    if( self->snapshot )
+        ssusysinfo_watch_stamp(self, &self->snapshot_stamp, watches, &count);
+
+    for( size_t i = 0; i < self->snapshot_dep_count; ++i )
+        ssusysinfo_watch_stamp(self, &self->snapshot_deps[i], watches, &count);
+
+    for( size_t id = 0; id < SOURCE_COUNT; ++id ) {
+        const ssusysinfo_source_t *src = &self->source[id];
+        for( size_t i = 0; i < src->count; ++i )
+            ssusysinfo_watch_stamp(self, &src->stamps[i], watches, &count);
+    }
+
+    /* Remove watches that are no longer needed */
+    for( size_t i = 0; i < self->watch_count; ++i ) {
+        bool keep = false;
+        for( size_t j = 0; !keep && j < count; ++j )
+            keep = (self->watches[i].wd == watches[j].wd);
+        if( !keep )
+            inotify_rm_watch(self->watch_fd, self->watches[i].wd);
+        free(self->watches[i].path);
+    }
+
+    free(self->watches);
+    self->watches     = watches;
+    self->watch_count = count;
+
+EXIT:
+    return;
+}
+
+/** Remove all inotify watches and close inotify file descriptor
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_watch_close(ssusysinfo_t *self)
+{
+    for( size_t i = 0; i < self->watch_count; ++i )
+        free(self->watches[i].path);
+
+    free(self->watches),
+        self->watches = 0, self->watch_count = 0;
+
+    if( self->watch_fd != -1 )
+        close(self->watch_fd), self->watch_fd = -1;
+}
+
+/** Check whether inotify event concerns any tracked path
+ *
+ * Watched directories can contain also unrelated files, changes
+ * to which should not cause reloading.
+ *
+ * @param self ssusysinfo object pointer
+ * @param eve  inotify event
+ *
+ * @return true if tracked paths need to be checked, false otherwise
+ */
+static bool
+ssusysinfo_watch_relevant(const ssusysinfo_t *self,
+                          const struct inotify_event *eve)
+{
+    const char *dir = 0;
+
+    if( eve->mask & IN_Q_OVERFLOW )
+        return true;
+
+    for( size_t i = 0; !dir && i < self->watch_count; ++i ) {
+        if( self->watches[i].wd == eve->wd )
+            dir = self->watches[i].path;
+    }
+
+    /* Events about the directory itself, or about stale watches */
+    if( !dir || !eve->len )
+        return true;
+
+    if( ssusysinfo_stamp_matches(&self->snapshot_stamp, dir, eve->name) )
+        return true;
+
+    for( size_t i = 0; i < self->snapshot_dep_count; ++i ) {
+        if( ssusysinfo_stamp_matches(&self->snapshot_deps[i], dir, eve->name) )
+            return true;
+    }
+
+    for( size_t id = 0; id < SOURCE_COUNT; ++id ) {
+        const ssusysinfo_source_t *src = &self->source[id];
+        for( size_t i = 0; i < src->count; ++i ) {
+            if( ssusysinfo_stamp_matches(&src->stamps[i], dir, eve->name) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/* ------------------------------------------------------------------------- *
+ * Internal Functions
+ * ------------------------------------------------------------------------- */
+
+/** Cache derived value
+ *
+ * @param self  ssusysinfo object pointer
+ * @param id    cached value slot
+ * @param value value to cache
+ *
+ * @return cached copy of the value
+ */
+static const char *
+ssusysinfo_cache_set(ssusysinfo_t *self, ssusysinfo_cached_id_t id,
+                     const char *value)
+{
+    free(self->cached[id]);
+    return self->cached[id] = xstrdup(value);
+}
+
+/** Forget cached values that depend on changed configuration
+ *
+ * @param self   ssusysinfo object pointer
+ * @param device true to forget values that depend on device model
+ *               data, false to forget values that depend on ssu.ini
+ */
+static void
+ssusysinfo_cache_forget(ssusysinfo_t *self, bool device)
+{
+    for( ssusysinfo_cached_id_t id = 0; id < CACHED_COUNT; ++id ) {
+        if( ssusysinfo_cached_lut[id].device == device )
+            free(self->cached[id]), self->cached[id] = 0;
+    }
+}
+
+/** Fill in cached values from snapshot
+ *
+ * @param self ssusysinfo object pointer
+ * @param db   snapshot database
+ */
+static void
+ssusysinfo_cache_import(ssusysinfo_t *self, const inidb_t *db)
+{
+    for( ssusysinfo_cached_id_t id = 0; id < CACHED_COUNT; ++id ) {
+        size_t sec = 0;
+
+        if( !ssusysinfo_cached_lut[id].sec )
+            continue;
+
+        if( !inidb_find_section(db, ssusysinfo_cached_lut[id].sec, &sec) )
+            continue;
+
+        for( size_t i = 0; i < inidb_value_count(db, sec); ++i ) {
+            const char *key = 0;
+            const char *val = 0;
+            int         ord = 0;
+            if( !inidb_value(db, sec, i, &key, &val, &ord) )
+                continue;
+            if( !strcmp(key, ssusysinfo_cached_lut[id].key) ) {
+                ssusysinfo_cache_set(self, id, val);
+                break;
+            }
+        }
+    }
+}
+
+/** Initialize freshly allocated configuration object to safe defaults
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_ctor(ssusysinfo_t *self)
+{
+    /* Config objects are kept for the lifetime of the handle so
+     * that reloading can recycle their arena memory */
+    for( size_t id = 0; id < SOURCE_COUNT; ++id )
+        ssusysinfo_source_ctor(&self->source[id]);
+
+    for( size_t id = 0; id < CACHED_COUNT; ++id )
+        self->cached[id] = 0;
+
+    self->feature_mask       = 0;
+    self->feature_mask_valid = false;
+
+    hw_key_set_init(&self->key_set);
+    self->key_set_valid = false;
+
+    self->snapshot  = 0;
+    self->loaded    = false;
+
+    self->snapshot_deps      = 0;
+    self->snapshot_dep_count = 0;
+
+    self->use_snapshot = true;
+
+    self->watch_fd    = -1;
+    self->watches     = 0;
+    self->watch_count = 0;
+    self->change_cb   = 0;
+    self->change_aptr = 0;
+
+    self->backing    = 0;
+    self->resolved   = 0;
+    self->retired    = 0;
+    self->epoch      = 0;
+    self->readers[0] = 0;
+    self->readers[1] = 0;
+}
+
+/** Release dynamic resources held by initialized  configuration object
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_dtor(ssusysinfo_t *self)
+{
+    if( self->backing ) {
+        ssusysinfo_delete(self->backing),
+            self->backing = 0;
+
+        ssusysinfo_resolved_delete(self->resolved),
+            self->resolved = 0;
+
+        while( self->retired ) {
+            ssusysinfo_resolved_t *res = self->retired;
+            self->retired = res->retired;
+            ssusysinfo_resolved_delete(res);
+        }
+
+        pthread_mutex_destroy(&self->lock);
+    }
+
+    ssusysinfo_watch_close(self);
+    ssusysinfo_unload(self);
+
+    /* Values not depending on loaded data can be cached also
+     * while the object is not in loaded state */
+    ssusysinfo_cache_forget(self, true);
+    ssusysinfo_cache_forget(self, false);
+
+    hw_key_set_clear(&self->key_set);
+
+    for( size_t id = 0; id < SOURCE_COUNT; ++id )
+        ssusysinfo_source_dtor(&self->source[id]);
+}
+
+/** Get content of a configuration source, loading it on first use
+ *
+ * Most callers are interested in just one or two values, so files
+ * are parsed only when something actually depends on them.
+ *
+ * @param self ssusysinfo object pointer
+ * @param id   configuration source
+ *
+ * @return config object
+ */
+static inifile_t *
+ssusysinfo_source_ini(ssusysinfo_t *self, ssusysinfo_source_id_t id)
+{
+    ssusysinfo_source_t *src = &self->source[id];
+
+    /* Snapshot, if available, provides content for all sources */
+    ssusysinfo_load(self);
+
+    if( !src->loaded ) {
+        src->loaded = true;
+        ssusysinfo_load_source(self, id);
+        ssusysinfo_watch_update(self);
+    }
+
+    return src->ini;
+}
+
+/** Lookup a value from device configuration sources
+ *
+ * Sources are checked in reverse load order, which yields the same
+ * result as merging all of them into one config object would.
+ *
+ * @param self ssusysinfo object pointer
+ * @param sec  section name
+ * @param key  key name
+ *
+ * @return c-string, or NULL if not found
+ */
+static const char *
+ssusysinfo_cfg_get(ssusysinfo_t *self, const char *sec, const char *key)
+{
+    static const ssusysinfo_source_id_t order[] = {
+        SOURCE_HW_SETTINGS,
+        SOURCE_RELEASE_INFO,
+        SOURCE_BOARD_MAPPINGS,
+    };
+
+    const char *val = 0;
+
+    for( size_t i = 0; !val && i < sizeof order / sizeof *order; ++i )
+        val = inifile_get(ssusysinfo_source_ini(self, order[i]), sec, key, 0);
+
+    return val;
+}
+
+/** Lookup a value from os-release / hw-release information
+ *
+ * @param self ssusysinfo object pointer
+ * @param sec  OS_RELEASE_SECTION or HW_RELEASE_SECTION
+ * @param key  key name
+ *
+ * @return c-string, or NULL if not found
+ */
+static const char *
+ssusysinfo_release_get(ssusysinfo_t *self, const char *sec, const char *key)
+{
+    return inifile_get(ssusysinfo_source_ini(self, SOURCE_RELEASE_INFO),
+                       sec, key, 0);
+}
+
+/** Lookup a section from board mappings
+ *
+ * @param self ssusysinfo object pointer
+ * @param sec  section name
+ *
+ * @return section object, or NULL if not found
+ */
+static inisec_t *
+ssusysinfo_board_section(ssusysinfo_t *self, const char *sec)
+{
+    return inifile_get_section(ssusysinfo_source_ini(self, SOURCE_BOARD_MAPPINGS),
+                               sec);
+}
+
+/** Append paths to a list of source files
+ *
+ * @param gl       list to append to
+ * @param pattern  glob pattern
+ * @param flags    extra glob flags, e.g. GLOB_NOCHECK for listing
+ *                 also paths that do not exist
+ */
+static void
+ssusysinfo_add_sources(glob_t *gl, const char *pattern, int flags)
+{
+    if( gl->gl_pathc )
+        flags |= GLOB_APPEND;
+    glob(pattern, flags, 0, gl);
+}
+
+/** Stamp paths in a list of source files
+ *
+ * Needs to be done before the sources are parsed, so that changes
+ * made meanwhile make the compiled database look out of date.
+ *
+ * @param stamps  stamps for paths preceding first, or NULL
+ * @param gl      list of source files
+ * @param first   index of the first path to stamp
+ *
+ * @return stamps for all paths in the list, or NULL on failure
+ */
+static inidb_stamp_t *
+ssusysinfo_stamp_sources(inidb_stamp_t *stamps, const glob_t *gl,
+                         size_t first)
+{
+    stamps = xrealloc(stamps, (gl->gl_pathc ?: 1) * sizeof *stamps);
+
+    for( size_t i = first; i < gl->gl_pathc; ++i ) {
+        if( !inidb_stamp(stamps + i, gl->gl_pathv[i]) ) {
+            free(stamps), stamps = 0;
+            break;
+        }
+    }
+
+    return stamps;
+}
+
+/** Parse board mapping configuration files
+ *
+ * Used both for loading board mappings at runtime and for compiling
+ * them into a database, so that the results are always the same.
+ *
+ * @param ini  config object to load data into
+ * @param gl   where to store paths of the parsed files
+ * @param src  source to track the parsed files in, or NULL
+ */
+static void
+ssusysinfo_parse_board_mappings(inifile_t *ini, glob_t *gl,
+                                ssusysinfo_source_t *src)
+{
+    if( glob(BOARD_MAPPINGS_PATTERN, 0, 0, gl) != 0 )
+        goto EXIT;
+
+    /* Stamp before reading, so that changes made meanwhile are noticed */
+    for( size_t i = 0; src && i < gl->gl_pathc; ++i )
+        ssusysinfo_source_track(src, gl->gl_pathv[i]);
+
+    iniload_files(ini, gl->gl_pathv, gl->gl_pathc, 0);
+
+EXIT:
+    return;
+}
+
+/** Load board mapping configuration files
+ *
+ * Uses compiled board mappings if available and up to date,
+ * parses the ini files otherwise.
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_load_board_mappings(ssusysinfo_t *self)
+{
+    ssusysinfo_source_t *src = &self->source[SOURCE_BOARD_MAPPINGS];
+
+    glob_t    gl  = {};
+    inidb_t  *db  = 0;
+    inisec_t *sec = 0;
+
+    ssusysinfo_source_track(src, BOARD_MAPPINGS_DB);
+
+    if( !(db = inidb_open(BOARD_MAPPINGS_DB)) )
+        goto PARSE;
+
+    if( inidb_is_current(db) ) {
+        /* Database stamps cover the board mapping files */
+        for( size_t i = 0; i < inidb_source_count(db); ++i )
+            ssusysinfo_source_track(src, inidb_source_path(db, i));
+        inifile_attach_db(src->ini, db);
+        goto EXIT;
+    }
+
+    log_notice("%s: out of date, ignored", BOARD_MAPPINGS_DB);
+    inidb_close(db);
+
+PARSE:
+    ssusysinfo_source_track(src, BOARD_MAPPINGS_DIR);
+    ssusysinfo_parse_board_mappings(src->ini, &gl, src);
+
+EXIT:
+    /* Model detection depends on presence of flag files */
+    sec = inifile_get_section(src->ini, "file.exists");
+    for( size_t i = 0; sec && i < inisec_elem_count(sec); ++i )
+        ssusysinfo_source_track(src, inival_get_val(inisec_elem(sec, i)));
+
+    globfree(&gl);
+}
+
+/** Load release information from list of possible file paths
+ *
+ * @param self     ssusysinfo object pointer
+ * @param paths    array of altrernate paths to try
+ * @param section  config section in which to store loaded data
+ */
+static void
+ssusysinfo_load_release_file(ssusysinfo_t *self, const char * const *paths,
+                             const char *section)
+{
+    ssusysinfo_source_t *src = &self->source[SOURCE_RELEASE_INFO];
+
+    for( ;; ) {
+        const char *path = *paths++;
+        if( !path ) {
+            log_warning("%s data not found", section);
+            break;
+        }
+        /* Track also missing alternatives, they could get created */
+        if( !ssusysinfo_source_track(src, path)->exists )
+            continue;
+        /* Note: The first existing alternative is used, regardless
+         *       of whether it can be successfully parsed or not. */
+        inifile_load(src->ini, path, section);
+        break;
+    }
+}
+
+/** Load release information configuration files
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_load_release_info(ssusysinfo_t *self)
+{
+    ssusysinfo_load_release_file(self, hw_release_paths, HW_RELEASE_SECTION);
+    ssusysinfo_load_release_file(self, os_release_paths, OS_RELEASE_SECTION);
+}
+
+/** Load CSD hw feature configuration files
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_load_hw_settings(ssusysinfo_t *self)
+{
+    ssusysinfo_source_t *src = &self->source[SOURCE_HW_SETTINGS];
+
+    glob_t gl = {};
+
+    ssusysinfo_source_track(src, HW_SETTINGS_DIR);
+
+    if (glob(HW_SETTINGS_PATTERN, 0, 0, &gl) == 0) {
+        for (size_t i = 0; i < gl.gl_pathc; ++i)
+            ssusysinfo_source_track(src, gl.gl_pathv[i]);
+        iniload_files(src->ini, gl.gl_pathv, gl.gl_pathc, 0);
+    }
+
+    globfree(&gl);
+}
+
+/** Load SSU configuration files
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_load_ssu_config(ssusysinfo_t *self)
+{
+    ssusysinfo_source_t *src = &self->source[SOURCE_SSU_CONFIG];
+
+    ssusysinfo_source_track(src, SSU_CONFIG_PATH);
+    inifile_load(src->ini, SSU_CONFIG_PATH, 0);
+
+    int version_want = EXPECTED_SSU_CONFIG_VERSION;
+    int version_have = ssusysinfo_ssu_config_version(self);
+    if( version_have != version_want ) {
+        log_warning("expected ssu config version %d, found %d",
+                    version_want, version_have);
+    }
+}
+
+/** Use resolved values snapshot
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return true if snapshot is available and up to date, false otherwise
+ */
+static bool
+ssusysinfo_load_snapshot(ssusysinfo_t *self)
+{
+    inidb_t *db = 0;
+
+    ssusysinfo_stamp_ctor(&self->snapshot_stamp, SNAPSHOT_DB);
+
+    if( !self->snapshot_stamp.exists )
+        goto FAIL;
+
+    if( !(db = inidb_open(SNAPSHOT_DB)) )
+        goto FAIL;
+
+    if( !inidb_is_current(db) ) {
+        log_notice("%s: out of date, ignored", SNAPSHOT_DB);
+        goto FAIL;
+    }
+
+    for( ssusysinfo_source_id_t id = 0; id < SOURCE_COUNT; ++id ) {
+#if SSU_INCLUDE_CREDENTIAL_ITEMS
+        /* Credentials are not included in the world readable snapshot */
+        if( id == SOURCE_SSU_CONFIG )
+            continue;
+#endif
+        inifile_attach_db(self->source[id].ini, inidb_ref(db));
+        self->source[id].loaded = true;
+    }
+    ssusysinfo_cache_import(self, db);
+
+    self->snapshot = db;
+    return true;
+
+FAIL:
+    inidb_close(db);
+    ssusysinfo_stamp_dtor(&self->snapshot_stamp);
+    return false;
+}
+
+/** Qsort callback for ordering values by value ordinal
+ */
+static int
+ssusysinfo_copy_section_cmp(const void *a, const void *b)
+{
+    int ord_a = inival_get_ord(*(inival_t * const *)a);
+    int ord_b = inival_get_ord(*(inival_t * const *)b);
+    return (ord_a > ord_b) - (ord_a < ord_b);
+}
+
+/** Copy section content from one config object to another
+ *
+ * Values are copied in load order, so that relative ordinals - which
+ * define precedence of model detection rules - are retained.
+ *
+ * @param dst   config object to copy to
+ * @param src   config object to copy from
+ * @param name  section name
+ * @param skip  NULL terminated array of keys not to copy, or NULL
+ */
+static void
+ssusysinfo_copy_section(inifile_t *dst, inifile_t *src, const char *name,
+                        const char * const *skip)
+{
+    inisec_t  *sec   = inifile_get_section(src, name);
+    size_t     count = sec ? inisec_elem_count(sec) : 0;
+    inival_t **vals  = xcalloc(count ?: 1, sizeof *vals);
+
+    for( size_t i = 0; i < count; ++i )
+        vals[i] = inisec_elem(sec, i);
+    qsort(vals, count, sizeof *vals, ssusysinfo_copy_section_cmp);
+
+    for( size_t i = 0; i < count; ++i ) {
+        inival_t   *val = vals[i];
+        const char *key = inival_get_key(val);
+
+        for( size_t j = 0; skip && skip[j]; ++j ) {
+            if( !strcmp(skip[j], key) )
+                goto NEXT;
+        }
+
+        inifile_set(dst, name, key, inival_get_val(val));
+NEXT:
+        ;
+    }
+
+    free(vals);
+}
+
+/** Reload configuration sources that have changed
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return true if anything was reloaded, false otherwise
+ */
+static bool
+ssusysinfo_refresh_sources(ssusysinfo_t *self)
+{
+    bool reloaded       = false;
+    bool device_changed = false;
+    bool ssu_changed    = false;
+
+    if( self->snapshot ) {
+        if( ssusysinfo_stamp_changed(&self->snapshot_stamp) ||
+            !inidb_is_current(self->snapshot) ) {
+            ssusysinfo_reload(self);
+            reloaded = true;
+            goto EXIT;
+        }
+    }
+
+    for( ssusysinfo_source_id_t id = 0; id < SOURCE_COUNT; ++id ) {
+        ssusysinfo_source_t *src = &self->source[id];
+
+        if( !ssusysinfo_source_changed(src) )
+            continue;
+
+        log_debug("reloading source %d", id);
+        ssusysinfo_source_reset(src);
+        ssusysinfo_load_source(self, id);
+        reloaded = true;
+
+        if( id == SOURCE_BOARD_MAPPINGS || id == SOURCE_RELEASE_INFO )
+            device_changed = true;
+        else if( id == SOURCE_SSU_CONFIG )
+            ssu_changed = true;
+
+        if( id != SOURCE_SSU_CONFIG ) {
+            self->feature_mask_valid = false;
+            self->key_set_valid      = false;
+        }
+    }
+
+    /* Device model and attributes need to be re-evaluated */
+    if( device_changed )
+        ssusysinfo_cache_forget(self, true);
+
+    if( ssu_changed )
+        ssusysinfo_cache_forget(self, false);
+
+    if( reloaded )
+        ssusysinfo_watch_update(self);
+
+EXIT:
+    return reloaded;
+}
+
+/** Load configuration files of one source
+ *
+ * @param self ssusysinfo object pointer
+ * @param id   configuration source
+ */
+static void
+ssusysinfo_load_source(ssusysinfo_t *self, ssusysinfo_source_id_t id)
+{
+    switch( id ) {
+    case SOURCE_SSU_CONFIG:
+        ssusysinfo_load_ssu_config(self);
+        break;
+    case SOURCE_BOARD_MAPPINGS:
+        ssusysinfo_load_board_mappings(self);
+        break;
+    case SOURCE_RELEASE_INFO:
+        ssusysinfo_load_release_info(self);
+        break;
+    case SOURCE_HW_SETTINGS:
+        ssusysinfo_load_hw_settings(self);
+        break;
+    default:
+        break;
+    }
+}
+
+/** Prepare for loading SSU configuration files
+ *
+ * If up to date snapshot is available, it is used for all sources.
+ * Otherwise configuration files are loaded on demand, one source
+ * at a time, via ssusysinfo_source_ini().
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_load(ssusysinfo_t *self)
+{
+    if( !self )
+        goto EXIT;
+
+    if( self->loaded )
+        goto EXIT;
+
+    self->loaded = true;
+
+    if( self->use_snapshot )
+        ssusysinfo_load_snapshot(self);
+
+    ssusysinfo_watch_update(self);
+
+EXIT:
+    return;
+}
+
+/** Unload all values from SSU configuration files
+ *
+ * @param self ssusysinfo object pointer
+ */
+static void
+ssusysinfo_unload(ssusysinfo_t *self)
+{
+    if( !self || !self->loaded )
+        goto EXIT;
+
+    self->loaded = false;
+
+    for( ssusysinfo_source_id_t id = 0; id < SOURCE_COUNT; ++id ) {
+        ssusysinfo_source_reset(&self->source[id]);
+        self->source[id].loaded = false;
+    }
+
+    ssusysinfo_cache_forget(self, true);
+    ssusysinfo_cache_forget(self, false);
+    self->feature_mask_valid = false;
+    self->key_set_valid      = false;
+
+    inidb_close(self->snapshot),
+        self->snapshot = 0;
+
+    ssusysinfo_stamp_dtor(&self->snapshot_stamp);
+
+    for( size_t i = 0; i < self->snapshot_dep_count; ++i )
+        ssusysinfo_stamp_dtor(&self->snapshot_deps[i]);
+
+    free(self->snapshot_deps),
+        self->snapshot_deps = 0, self->snapshot_dep_count = 0;
+
+EXIT:
+    return;
+}
+
+/** Evaluate mask of supported hw features
+ *
+ * Features sections of all sources are scanned once, in load order
+ * so that later sources override earlier ones as with cfg_get().
+ * Features not mentioned anywhere get their fallback values.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return bitmask with bit N set if feature N is supported
+ */
+static uint64_t
+ssusysinfo_evaluate_feature_mask(ssusysinfo_t *self)
+{
+    static const ssusysinfo_source_id_t order[] = {
+        SOURCE_BOARD_MAPPINGS,
+        SOURCE_RELEASE_INFO,
+        SOURCE_HW_SETTINGS,
+    };
+
+    uint64_t mask = hw_feature_fallback_mask();
+
+    for( size_t i = 0; i < sizeof order / sizeof *order; ++i ) {
+        inifile_t *ini = ssusysinfo_source_ini(self, order[i]);
+        inisec_t  *sec = inifile_get_section(ini, "features");
+
+        for( size_t j = 0; sec && j < inisec_elem_count(sec); ++j ) {
+            inival_t    *val = inisec_elem(sec, j);
+            hw_feature_t id  = hw_feature_from_csd_key(inival_get_key(val));
+
+            if( id == Feature_Invalid )
+                continue;
+
+            if( strtol(inival_get_val(val), 0, 0) != 0 )
+                mask |= UINT64_C(1) << id;
+            else
+                mask &= ~(UINT64_C(1) << id);
+        }
+    }
+
+    return mask;
+}
+
+/** Get set of supported hw keys, parsing it on first use
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return set of keys, valid until sources are reloaded
+ */
+static const hw_key_set_t *
+ssusysinfo_hw_key_set(ssusysinfo_t *self)
+{
+    if( !self->key_set_valid ) {
+        hw_key_set_parse(&self->key_set,
+                         ssusysinfo_cfg_get(self, "Keys", "Keys"));
+        self->key_set_valid = true;
+    }
+
+    return &self->key_set;
+}
+
+/** Append entries of a board mappings section to device model detection plan
+ *
+ * Entries are inserted in order of precedence, i.e. by descending
+ * ordinal, with later entries first among equal ordinals.
+ *
+ * @param sec   section to add, or NULL
+ * @param kind  type of rules in the section
+ * @param plan  array to add to, with room for the entries
+ * @param used  number of rules already in the array
+ *
+ * @return number of rules in the array
+ */
+static size_t
+ssusysinfo_model_plan_section(inisec_t *sec, ssusysinfo_model_rule_kind_t kind,
+                              ssusysinfo_plan_rule_t *plan, size_t used)
+{
+    size_t count = sec ? inisec_elem_count(sec) : 0;
+    size_t first = used;
+
+    for( size_t i = 0; i < count; ++i ) {
+        inival_t *val = inisec_elem(sec, i);
+        int       ord = inival_get_ord(val);
+        size_t    j   = used++;
+
+        for( ; j > first && plan[j - 1].ord <= ord; --j )
+            plan[j] = plan[j - 1];
+
+        plan[j].kind  = kind;
+        plan[j].value = inival_get_val(val);
+        plan[j].model = inival_get_key(val);
+        plan[j].ord   = ord;
+        plan[j].id    = -1;
+    }
+
+    return used;
+}
+
+/** Compile device model detection rules into a plan
+ *
+ * All rules are placed in a single array in order of precedence:
+ * flag files come first so that detecting "sdk" / "sdk-target" works
+ * regardless of what product configuration files are installed in the
+ * sdk, then hw-release data, and finally /proc/cpuinfo heuristics.
+ *
+ * @param self    ssusysinfo object pointer
+ * @param pcount  where to store the number of rules
+ *
+ * @return array of rules, to be released with free()
+ */
+static ssusysinfo_plan_rule_t *
+ssusysinfo_model_plan(ssusysinfo_t *self, size_t *pcount)
+{
+    inisec_t *files = ssusysinfo_board_section(self, "file.exists");
+    inisec_t *cpu   = ssusysinfo_board_section(self, "cpuinfo.contains");
+    size_t    total = 1;
+
+    total += files ? inisec_elem_count(files) : 0;
+    total += cpu   ? inisec_elem_count(cpu)   : 0;
+
+    ssusysinfo_plan_rule_t *plan = xcalloc(total, sizeof *plan);
+    size_t                  used = 0;
+
+    used = ssusysinfo_model_plan_section(files, MODEL_RULE_FILE_EXISTS,
+                                         plan, used);
+
+    plan[used].kind  = MODEL_RULE_HW_RELEASE;
+    plan[used].value = "MER_HA_DEVICE";
+    plan[used].id    = -1;
+    ++used;
+
+    size_t first = used;
+    used = ssusysinfo_model_plan_section(cpu, MODEL_RULE_CPUINFO, plan, used);
+
+    /* Cpuinfo patterns are matched together; pattern ids must grow
+     * with precedence, see acmatch_scan_fd() */
+    for( size_t i = first; i < used; ++i )
+        plan[i].id = (int)(used - 1 - i);
+
+    *pcount = used;
+    return plan;
+}
+
+/** Look for cpuinfo patterns of the detection plan in one pass
+ *
+ * @param rules  cpuinfo rules, in order of precedence
+ * @param count  number of rules
+ *
+ * @return id of the matching rule with highest precedence, or -1
+ */
+static int
+ssusysinfo_model_scan_cpuinfo(const ssusysinfo_plan_rule_t *rules, size_t count)
+{
+    int        res   = -1;
+    int        fd    = -1;
+    acmatch_t *match = 0;
+
+    if( (fd = open("/proc/cpuinfo", O_RDONLY | O_CLOEXEC)) == -1 )
+        goto EXIT;
+
+    match = acmatch_create();
+    for( size_t i = count; i-- > 0; )
+        acmatch_add(match, rules[i].value);
+    acmatch_compile(match);
+
+    res = acmatch_scan_fd(match, fd);
+
+EXIT:
+    acmatch_delete(match);
+
+    if( fd != -1 )
+        close(fd);
+
+    return res;
+}
+
+/** Get current time in nanoseconds, for explaining model detection
+ */
+static uint64_t
+ssusysinfo_model_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+/** Determine device model by evaluating detection rules
+ *
+ * Rules are evaluated in order of precedence, and evaluation stops
+ * at the first matching rule, so that e.g. flag files with lower
+ * precedence are not checked at all.
+ *
+ * @param self  ssusysinfo object pointer
+ * @param cb    callback for reporting evaluated rules, or NULL
+ * @param aptr  user data pointer to pass to the callback
+ *
+ * @return c-string, or NULL in case model can't be determined
+ */
+static const char *
+ssusysinfo_device_model_detect(ssusysinfo_t *self,
+                               ssusysinfo_model_rule_cb cb, void *aptr)
+{
+    const char             *res     = 0;
+    size_t                  count   = 0;
+    ssusysinfo_plan_rule_t *plan    = ssusysinfo_model_plan(self, &count);
+    int                     cpuinfo = -1;
+    bool                    scanned = false;
+
+    for( size_t i = 0; !res && i < count; ++i ) {
+        ssusysinfo_plan_rule_t *rule    = &plan[i];
+        bool                    matched = false;
+        uint64_t                started = cb ? ssusysinfo_model_clock() : 0;
+
+        switch( rule->kind ) {
+        case MODEL_RULE_FILE_EXISTS:
+            /* Path given in ini-file exists in file system */
+            matched = fileutil_exists(rule->value);
+            break;
+
+        case MODEL_RULE_HW_RELEASE:
+            /* Normally it should be defined in hw-config file. Looked
+             * up only here, so that release info does not get loaded
+             * when a flag file already determined the model. */
+            rule->model = ssusysinfo_release_get(self, HW_RELEASE_SECTION,
+                                                 rule->value);
+            matched = rule->model != 0;
+            break;
+
+        case MODEL_RULE_CPUINFO:
+            /* String given in ini-file exists in cpuinfo */
+            if( !scanned ) {
+                cpuinfo = ssusysinfo_model_scan_cpuinfo(rule, count - i);
+                scanned = true;
+            }
+            matched = rule->id == cpuinfo;
+            break;
+        }
+
+        if( matched )
+            res = rule->model;
+
+        if( cb ) {
+            ssusysinfo_model_rule_t report = {
+                .rule    = ssusysinfo_model_rule_name[rule->kind],
+                .value   = rule->value,
+                .model   = rule->model,
+                .matched = matched,
+                .nsec    = ssusysinfo_model_clock() - started,
+            };
+            cb(&report, aptr);
+        }
+    }
+
+    free(plan);
+
+    return res;
+}
+
+/** Lookup a key in device mode specific section from board mappings
+ *
+ * @param self ssusysinfo object pointer
+ * @param key  key name used in board config ini files
+ *
+ * @return c-string
+ */
+static const char *
+ssusysinfo_device_attr(ssusysinfo_t *self, ssusysinfo_cached_id_t id)
+{
+    const char *key    = ssusysinfo_cached_lut[id].key;
+    const char *cached = 0;
+    const char *probed = 0;
+    const char *model  = 0;
+    const char *base   = 0;
+
+    if( !self )
+        goto EXIT;
+
+    /* Check if this attr has already been resolved */
+    if( (cached = self->cached[id]) )
+        goto EXIT;
+
+    /* Attempt to resolve based on model name */
+    if( (model = ssusysinfo_device_model(self)) ) {
+        if( (probed = ssusysinfo_cfg_get(self, model, key)) )
+            goto CACHE;
+    }
+
+    /* In case of variant, attempt to resolve based on base model name */
+    if( (base = ssusysinfo_device_base_model(self)) ) {
+        if( (probed = ssusysinfo_cfg_get(self, base, key)) )
+            goto CACHE;
+    }
+
+    /* Use model name as fallback for some attrs */
+    if( id == CACHED_DESIGNATION || id == CACHED_PRETTY_NAME )
+        probed = model;
+
+    /* And as an ultimate fallback select unknown */
+    if( !probed )
+        probed = ssusysinfo_unknown;
+
+CACHE:
+    /* Update the cache so that we do not need to repeat the above
+     * heuristics the next time */
+    cached = ssusysinfo_cache_set(self, id, probed);
+
+EXIT:
+
+    /* Always return valid c-string */
+    return cached ?: ssusysinfo_unknown;
+}
+
+/* ------------------------------------------------------------------------- *
+ * Public Functions
+ * ------------------------------------------------------------------------- */
+
+/* NOTE: Public functions are documented in ssusysinfo.h header file which
+ *       is included in the development package.
+ */
+
+ssusysinfo_t *
+ssusysinfo_create(void)
+{
+    ssusysinfo_t *self = xcalloc(1, sizeof *self);
+
+    ssusysinfo_ctor(self);
+    ssusysinfo_load(self);
+
+    return self;
+}
+
+ssusysinfo_t *
+ssusysinfo_create_threadsafe(void)
+{
+    ssusysinfo_t *self = xcalloc(1, sizeof *self);
+
+    ssusysinfo_ctor(self);
+    pthread_mutex_init(&self->lock, 0);
+    self->backing = ssusysinfo_create();
+
+    return self;
+}
+
+void
+ssusysinfo_delete(ssusysinfo_t *self)
+{
+    /* Deleting the process wide handle just drops a reference */
+    if( ssusysinfo_release_global(self) )
+        return;
+
+    if( self != 0 )
+    {
+        ssusysinfo_dtor(self);
+        free(self);
+    }
+}
+
+void
+ssusysinfo_delete_cb(void *self)
+{
+    ssusysinfo_delete(self);
+}
+
+ssusysinfo_t *
+ssusysinfo_acquire(void)
+{
+    pthread_mutex_lock(&ssusysinfo_global_lock);
+
+    if( !ssusysinfo_global_handle )
+        ssusysinfo_global_handle = ssusysinfo_create_threadsafe();
+
+    ++ssusysinfo_global_refs;
+
+    ssusysinfo_t *self = ssusysinfo_global_handle;
+
+    pthread_mutex_unlock(&ssusysinfo_global_lock);
+
+    return self;
+}
+
+void
+ssusysinfo_release(ssusysinfo_t *self)
+{
+    if( self && !ssusysinfo_release_global(self) )
+        log_warning("releasing handle that was not acquired");
+}
+
+/** Drop a reference to the process wide handle
+ *
+ * The handle is deleted when the last reference is dropped.
+ *
+ * @param self ssusysinfo object pointer, or NULL
+ *
+ * @return true if self is the process wide handle, false otherwise
+ */
+static bool
+ssusysinfo_release_global(ssusysinfo_t *self)
+{
+    bool          is_global = false;
+    ssusysinfo_t *unused    = 0;
+
+    if( !self )
+        goto EXIT;
+
+    pthread_mutex_lock(&ssusysinfo_global_lock);
+
+    if( self == ssusysinfo_global_handle ) {
+        is_global = true;
+        if( --ssusysinfo_global_refs == 0 ) {
+            unused = ssusysinfo_global_handle;
+            ssusysinfo_global_handle = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&ssusysinfo_global_lock);
+
+    if( unused ) {
+        ssusysinfo_dtor(unused);
+        free(unused);
+    }
+
+EXIT:
+    return is_global;
+}
+
+void
+ssusysinfo_reload(ssusysinfo_t *self)
+{
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        ssusysinfo_reload(self->backing);
+        ssusysinfo_publish(self);
+        pthread_mutex_unlock(&self->lock);
+        return;
+    }
+
+    ssusysinfo_unload(self);
+    ssusysinfo_load(self);
+}
+
+void
+ssusysinfo_refresh(ssusysinfo_t *self)
+{
+    if( !self )
+        goto EXIT;
+
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        ssusysinfo_refresh(self->backing);
+        if( self->resolved )
+            ssusysinfo_publish(self);
+        pthread_mutex_unlock(&self->lock);
+        goto EXIT;
+    }
+
+    if( !self->loaded )
+        ssusysinfo_load(self);
+    else
+        ssusysinfo_refresh_sources(self);
+
+EXIT:
+    return;
+}
+
+int
+ssusysinfo_get_watch_fd(ssusysinfo_t *self)
+{
+    if( !self )
         goto EXIT;
 
-    for( size_t i = 0; ; ++i ) {
-        inival_t *val = inisec_elem(sec, i);
-        if( !val )
-            break;
-
-        /* Later than current choise in the ini-file */
-        if( res && inival_get_ord(res) > inival_get_ord(val) )
-            continue;
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        int fd = ssusysinfo_get_watch_fd(self->backing);
+        pthread_mutex_unlock(&self->lock);
+        return fd;
+    }
 
-        /* String given in ini-file exists in cpuinfo */
-        if( strstr(text, inival_get_val(val)) )
-            res = val;
+    if( self->watch_fd == -1 ) {
+        self->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if( self->watch_fd == -1 )
+            log_warning("inotify_init: %m");
+        else
+            ssusysinfo_watch_update(self);
     }
 
 EXIT:
-    free(text);
-
-    return res ? inival_get_key(res) : 0;
+    return self ? self->watch_fd : -1;
 }
 
-/** Try to determine device model based on flag file configuration
- *
- * @param self ssusysinfo object pointer
- *
- * @return c-string, or NULL in case model can't be determined
- */
-static const char *
-ssusysinfo_device_model_from_flagfiles(ssusysinfo_t *self)
+unsigned
+ssusysinfo_process_events(ssusysinfo_t *self)
 {
-    inival_t *res = 0;
-    inisec_t *sec = 0;
+    unsigned changed  = 0;
+    bool     relevant = false;
+
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        changed = ssusysinfo_process_events(self->backing);
+        if( changed && self->resolved )
+            ssusysinfo_publish(self);
+        ssusysinfo_change_cb cb   = self->change_cb;
+        void                *aptr = self->change_aptr;
+        pthread_mutex_unlock(&self->lock);
 
-    if( !self || !self->cfg_ini )
+        /* Notify without holding the lock, so that the callback
+         * can make queries and modify the handle */
+        if( changed && cb )
+            cb(self, changed, aptr);
         goto EXIT;
+    }
 
-    if( !(sec = inifile_get_section(self->cfg_ini, "file.exists")) )
+    if( !self || self->watch_fd == -1 )
         goto EXIT;
 
-    for( size_t i = 0; ; ++i ) {
-        inival_t *val = inisec_elem(sec, i);
-        if( !val )
+    /* Drain the queue, then check the tracked paths only once */
+    for( ;; ) {
+        char buf[4096]
+            __attribute__((aligned(__alignof__(struct inotify_event))));
+
+        ssize_t rc = read(self->watch_fd, buf, sizeof buf);
+        if( rc == -1 ) {
+            if( errno == EINTR )
+                continue;
+            if( errno != EAGAIN )
+                log_warning("inotify read: %m");
             break;
+        }
 
-        /* Later than current choise in the ini-file */
-        if( res && inival_get_ord(res) > inival_get_ord(val) )
-            continue;
+        for( char *pos = buf; pos < buf + rc; ) {
+            const struct inotify_event *eve = (const void *)pos;
+            pos += sizeof *eve + eve->len;
+            if( !relevant )
+                relevant = ssusysinfo_watch_relevant(self, eve);
+        }
+    }
+
+    if( !relevant || !self->loaded )
+        goto EXIT;
+
+    ssusysinfo_fields_t prev = {};
+    ssusysinfo_fields_t curr = {};
 
-        /* Path given in ini-file exists in file system */
-        if( fileutil_exists(inival_get_val(val)) )
-            res = val;
+    ssusysinfo_fields_capture(self, &prev);
+
+    if( ssusysinfo_refresh_sources(self) ) {
+        ssusysinfo_fields_capture(self, &curr);
+        changed = ssusysinfo_fields_diff(&prev, &curr);
+        ssusysinfo_fields_release(&curr);
     }
 
+    ssusysinfo_fields_release(&prev);
+
+    if( changed && self->change_cb )
+        self->change_cb(self, changed, self->change_aptr);
+
 EXIT:
-    return res ? inival_get_key(res) : 0;
+    return changed;
 }
 
-/** Try to determine device model based on /etc/hw-release content
- *
- * @param self ssusysinfo object pointer
- *
- * @return c-string, or NULL in case model can't be determined
- */
-static const char *
-ssusysinfo_device_model_from_hw_release(ssusysinfo_t *self)
+void
+ssusysinfo_set_change_cb(ssusysinfo_t *self, ssusysinfo_change_cb cb,
+                         void *aptr)
+{
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        self->change_cb   = cb;
+        self->change_aptr = aptr;
+        pthread_mutex_unlock(&self->lock);
+    }
+    else if( self ) {
+        self->change_cb   = cb;
+        self->change_aptr = aptr;
+    }
+}
+
+unsigned
+ssusysinfo_read_begin(ssusysinfo_t *self)
 {
-    const char *res = 0;
+    unsigned epoch = 0;
 
-    if( !self || !self->cfg_ini )
+    if( !ssusysinfo_is_shared(self) )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, HW_RELEASE_SECTION, "MER_HA_DEVICE", 0);
+    /* Register to the current epoch. If the epoch got advanced
+     * meanwhile, the writer might have missed the registration. */
+    for( ;; ) {
+        epoch = __atomic_load_n(&self->epoch, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&self->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+        if( __atomic_load_n(&self->epoch, __ATOMIC_SEQ_CST) == epoch )
+            break;
+        __atomic_sub_fetch(&self->readers[epoch & 1], 1, __ATOMIC_SEQ_CST);
+    }
+
+    /* Pin the values for the duration of the outermost read section.
+     * Should the thread run out of slots, queries just are not
+     * guaranteed to see the same values. */
+    ssusysinfo_pin_t *pin = ssusysinfo_pin_find(self);
+    if( pin ) {
+        ++pin->depth;
+    }
+    else if( (pin = ssusysinfo_pin_find(0)) ) {
+        pin->resolved = ssusysinfo_resolved_current(self);
+        pin->handle   = self;
+        pin->depth    = 1;
+    }
 
 EXIT:
-    return res;
+    return epoch;
 }
 
-/** Lookup a key in device mode specific section from board mappings
- *
- * @param self ssusysinfo object pointer
- * @param key  key name used in board config ini files
- *
- * @return c-string
- */
-static const char *
-ssusysinfo_device_attr(ssusysinfo_t *self, const char *key)
+void
+ssusysinfo_read_end(ssusysinfo_t *self, unsigned token)
 {
-    const char *cached = 0;
-    const char *probed = 0;
-    const char *model  = 0;
-    const char *base   = 0;
+    if( !ssusysinfo_is_shared(self) )
+        goto EXIT;
+
+    ssusysinfo_pin_t *pin = ssusysinfo_pin_find(self);
+    if( pin && --pin->depth == 0 ) {
+        pin->handle   = 0;
+        pin->resolved = 0;
+    }
 
-    if( !self || !self->cfg_ini )
+    if( __atomic_sub_fetch(&self->readers[token & 1], 1, __ATOMIC_SEQ_CST) )
         goto EXIT;
 
-    /* Check if this attr has already been resolved */
-    if( (cached = inifile_get(self->cfg_ini, "cached-attrs", key, 0)) )
+    /* Last reader of an epoch left - release what can be released,
+     * unless a writer is busy, in which case it will do it */
+    if( !__atomic_load_n(&self->retired, __ATOMIC_ACQUIRE) )
         goto EXIT;
 
-    /* Attempt to resolve based on model name */
-    if( (model = ssusysinfo_device_model(self)) ) {
-        if( (probed = inifile_get(self->cfg_ini, model, key, 0)) )
-            goto CACHE;
+    if( pthread_mutex_trylock(&self->lock) == 0 ) {
+        ssusysinfo_reclaim(self);
+        pthread_mutex_unlock(&self->lock);
     }
 
-    /* In case of variant, attempt to resolve based on base model name */
-    if( (base = ssusysinfo_device_base_model(self)) ) {
-        if( (probed = inifile_get(self->cfg_ini, base, key, 0)) )
-            goto CACHE;
-    }
+EXIT:
+    return;
+}
 
-    /* Use model name as fallback for some attrs */
-    if( !strcmp(key, "deviceDesignation") || !strcmp(key, "prettyModel") )
-        probed = model;
+bool
+ssusysinfo_compile_board_mappings(const char *path)
+{
+    bool           ack    = false;
+    glob_t         gl     = {};
+    glob_t         src    = {};
+    inifile_t     *ini    = 0;
+    inidb_stamp_t *stamps = 0;
 
-    /* And as an ultimate fallback select unknown */
-    if( !probed )
-        probed = ssusysinfo_unknown;
+    /* Stamping the directory catches added / removed files */
+    ssusysinfo_add_sources(&src, BOARD_MAPPINGS_DIR, GLOB_NOCHECK);
+    ssusysinfo_add_sources(&src, BOARD_MAPPINGS_PATTERN, 0);
 
-CACHE:
-    /* Update the cache so that we do not need to repeat the above
-     * heuristics the next time */
-    inifile_set(self->cfg_ini, "cached-attrs", key, (cached = probed));
+    if( !(stamps = ssusysinfo_stamp_sources(0, &src, 0)) )
+        goto EXIT;
+
+    /* Use exactly the same logic as when parsing at runtime */
+    ini = inifile_create();
+    ssusysinfo_parse_board_mappings(ini, &gl, 0);
+
+    ack = inidb_write(path ?: BOARD_MAPPINGS_DB, ini, stamps, src.gl_pathc);
 
 EXIT:
+    inifile_delete(ini);
+    free(stamps);
+    globfree(&src);
+    globfree(&gl);
 
-    /* Always return valid c-string */
-    return cached ?: ssusysinfo_unknown;
+    return ack;
 }
 
-/* ------------------------------------------------------------------------- *
- * Public Functions
- * ------------------------------------------------------------------------- */
+bool
+ssusysinfo_write_snapshot(const char *path)
+{
+    static const char * const secret_keys[] = {
+        "certificate",
+        "privateKey",
+        NULL
+    };
+
+    bool           ack    = false;
+    glob_t         gl     = {};
+    inidb_stamp_t *stamps = 0;
+    inifile_t     *snap   = inifile_create();
+    ssusysinfo_t  *info   = xcalloc(1, sizeof *info);
+
+    /* Resolve values from the source files, not from a snapshot */
+    ssusysinfo_ctor(info);
+    info->use_snapshot = false;
+
+    /* Stamp everything that affects the resolved values before
+     * anything is loaded, so that changes made while the snapshot
+     * is being written make it look out of date */
+    ssusysinfo_add_sources(&gl, SSU_CONFIG_PATH, GLOB_NOCHECK);
+    ssusysinfo_add_sources(&gl, BOARD_MAPPINGS_DIR, GLOB_NOCHECK);
+    ssusysinfo_add_sources(&gl, BOARD_MAPPINGS_PATTERN, 0);
+    for( size_t i = 0; hw_release_paths[i]; ++i )
+        ssusysinfo_add_sources(&gl, hw_release_paths[i], GLOB_NOCHECK);
+    for( size_t i = 0; os_release_paths[i]; ++i )
+        ssusysinfo_add_sources(&gl, os_release_paths[i], GLOB_NOCHECK);
+    ssusysinfo_add_sources(&gl, HW_SETTINGS_DIR, GLOB_NOCHECK);
+    ssusysinfo_add_sources(&gl, HW_SETTINGS_PATTERN, 0);
+
+    if( !(stamps = ssusysinfo_stamp_sources(stamps, &gl, 0)) )
+        goto EXIT;
 
-/* NOTE: Public functions are documented in ssusysinfo.h header file which
- *       is included in the development package.
- */
+    ssusysinfo_load(info);
 
-ssusysinfo_t *
-ssusysinfo_create(void)
-{
-    ssusysinfo_t *self = xcalloc(1, sizeof *self);
+    /* Flag files are known only after board mappings are loaded,
+     * but they are not looked at before model detection */
+    size_t    done  = gl.gl_pathc;
+    inisec_t *flags = ssusysinfo_board_section(info, "file.exists");
+    for( size_t i = 0; flags && i < inisec_elem_count(flags); ++i ) {
+        inival_t *val = inisec_elem(flags, i);
+        ssusysinfo_add_sources(&gl, inival_get_val(val), GLOB_NOCHECK);
+    }
 
-    ssusysinfo_ctor(self);
-    ssusysinfo_load(self);
+    if( !(stamps = ssusysinfo_stamp_sources(stamps, &gl, done)) )
+        goto EXIT;
 
-    return self;
-}
+    /* Evaluate all values that are cached on first use */
+    ssusysinfo_device_model(info);
+    ssusysinfo_device_base_model(info);
+    ssusysinfo_device_designation(info);
+    ssusysinfo_device_manufacturer(info);
+    ssusysinfo_device_pretty_name(info);
+    ssusysinfo_board_version(info);
+    ssusysinfo_ssu_last_credentials_update(info);
+
+    inifile_t *ssu_ini = ssusysinfo_source_ini(info, SOURCE_SSU_CONFIG);
+    inifile_t *rel_ini = ssusysinfo_source_ini(info, SOURCE_RELEASE_INFO);
+
+    for( ssusysinfo_cached_id_t id = 0; id < CACHED_COUNT; ++id ) {
+        if( ssusysinfo_cached_lut[id].sec && info->cached[id] )
+            inifile_set(snap, ssusysinfo_cached_lut[id].sec,
+                        ssusysinfo_cached_lut[id].key, info->cached[id]);
+    }
+    ssusysinfo_copy_section(snap, rel_ini, OS_RELEASE_SECTION, 0);
+    ssusysinfo_copy_section(snap, rel_ini, HW_RELEASE_SECTION, 0);
 
-void
-ssusysinfo_delete(ssusysinfo_t *self)
-{
-    if( self != 0 )
-    {
-        ssusysinfo_dtor(self);
-        free(self);
+    /* Model detection rules, so that explaining the detection
+     * works also when values come from the snapshot */
+    inifile_t *map_ini = ssusysinfo_source_ini(info, SOURCE_BOARD_MAPPINGS);
+    ssusysinfo_copy_section(snap, map_ini, "file.exists", 0);
+    ssusysinfo_copy_section(snap, map_ini, "cpuinfo.contains", 0);
+
+    const char *keys = ssusysinfo_cfg_get(info, "Keys", "Keys");
+    if( keys )
+        inifile_set(snap, "Keys", "Keys", keys);
+
+    /* Store all features, with fallback values applied */
+    for( hw_feature_t id = Feature_Invalid + 1; id < Feature_Count; ++id ) {
+        inifile_set(snap, "features", hw_feature_to_csd_key(id),
+                    ssusysinfo_has_hw_feature(info, id) ? "1" : "0");
     }
-}
 
-void
-ssusysinfo_delete_cb(void *self)
-{
-    ssusysinfo_delete(self);
+    /* Credential sections are left out altogether */
+    ssusysinfo_copy_section(snap, ssu_ini, "General", secret_keys);
+
+    ack = inidb_write(path ?: SNAPSHOT_DB, snap, stamps, gl.gl_pathc);
+
+EXIT:
+    free(stamps);
+    globfree(&gl);
+    ssusysinfo_delete(info);
+    inifile_delete(snap);
+
+    return ack;
 }
 
-void
-ssusysinfo_reload(ssusysinfo_t *self)
+int
+ssusysinfo_scan_ini(const char *path, const char *defsec,
+                    ssusysinfo_ini_cb cb, void *aptr)
 {
-    ssusysinfo_unload(self);
-    ssusysinfo_load(self);
+    if( !path || !cb )
+        return -1;
+
+    return inifile_scan(path, defsec, cb, aptr);
 }
 
 const char *
@@ -860,17 +3079,20 @@ ssusysinfo_device_base_model(ssusysinfo_t *self)
     const char *cached = 0;
     const char *probed = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_DEVICE_BASE_MODEL);
+
+    if( !self )
         goto EXIT;
 
-    if( (cached = inifile_get(self->cfg_ini, "cached-values", "base_model", 0)) )
+    if( (cached = self->cached[CACHED_BASE_MODEL]) )
         goto EXIT;
 
     /* Get model name, which is potentially a variant */
     const char *model = ssusysinfo_device_model(self);
 
     /* Lookup base model from [variants] */
-    if( (probed = inifile_get(self->cfg_ini, "variants", model, 0)) )
+    if( (probed = ssusysinfo_cfg_get(self, "variants", model)) )
         goto CACHE;
 
     /* We have data, but were unable to determine base model */
@@ -879,7 +3101,7 @@ ssusysinfo_device_base_model(ssusysinfo_t *self)
 CACHE:
     /* Update the cache so that we do not need to repeat the above
      * heuristics the next time */
-    inifile_set(self->cfg_ini, "cached-values", "base_model", (cached = probed));
+    cached = ssusysinfo_cache_set(self, CACHED_BASE_MODEL, probed);
 
 EXIT:
     /* Always return valid c-string */
@@ -892,66 +3114,84 @@ ssusysinfo_device_model(ssusysinfo_t *self)
     const char *cached = 0;
     const char *probed = 0;
 
-    if( !self || !self->cfg_ini )
-        goto EXIT;
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_DEVICE_MODEL);
 
-    if( (cached = inifile_get(self->cfg_ini, "cached-values", "model", 0)) )
+    if( !self )
         goto EXIT;
 
-    /* Guess by looking at flag files - this needs to be done 1st
-     * so that detecting "sdk" / "sdk-target" works gegardless of
-     * what product configuration files are installed in the sdk. */
-    if( (probed = ssusysinfo_device_model_from_flagfiles(self)) )
-        goto CACHE;
-
-    /* Normally it should be defined in hw-config file */
-    if( (probed = ssusysinfo_device_model_from_hw_release(self)) )
-        goto CACHE;
-
-    /* Attempt some /proc/cpyinfo based heuristics */
-    if( (probed = ssusysinfo_device_model_from_cpuinfo(self)) )
-        goto CACHE;
+    if( (cached = self->cached[CACHED_MODEL]) )
+        goto EXIT;
 
-    /* We have data, but were unable to determine device model */
-    probed = ssusysinfo_unknown;
+    /* We might have data, but be unable to determine device model */
+    if( !(probed = ssusysinfo_device_model_detect(self, 0, 0)) )
+        probed = ssusysinfo_unknown;
 
-CACHE:
     /* Update the cache so that we do not need to repeat the above
      * heuristics the next time */
-    inifile_set(self->cfg_ini, "cached-values", "model", (cached = probed));
+    cached = ssusysinfo_cache_set(self, CACHED_MODEL, probed);
 
 EXIT:
     /* Always return valid c-string */
     return cached ?: ssusysinfo_unknown;
 }
 
+void
+ssusysinfo_explain_device_model(ssusysinfo_t *self,
+                                ssusysinfo_model_rule_cb cb, void *aptr)
+{
+    if( !self || !cb )
+        goto EXIT;
+
+    if( ssusysinfo_is_shared(self) ) {
+        pthread_mutex_lock(&self->lock);
+        ssusysinfo_explain_device_model(self->backing, cb, aptr);
+        pthread_mutex_unlock(&self->lock);
+        goto EXIT;
+    }
+
+    ssusysinfo_device_model_detect(self, cb, aptr);
+
+EXIT:
+    return;
+}
+
 const char *
 ssusysinfo_device_designation(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_DEVICE_DESIGNATION);
+
     /* Always returns valid c-string */
-    return ssusysinfo_device_attr(self, "deviceDesignation");
+    return ssusysinfo_device_attr(self, CACHED_DESIGNATION);
 }
 
 const char *
 ssusysinfo_device_manufacturer(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_DEVICE_MANUFACTURER);
+
     /* Always returns valid c-string */
-    return ssusysinfo_device_attr(self, "deviceManufacturer");
+    return ssusysinfo_device_attr(self, CACHED_MANUFACTURER);
 }
 
 const char *
 ssusysinfo_device_pretty_name(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_DEVICE_PRETTY_NAME);
+
     /* Always returns valid c-string */
-    return ssusysinfo_device_attr(self, "prettyModel");
+    return ssusysinfo_device_attr(self, CACHED_PRETTY_NAME);
 }
 
 static const char *
 ssusysinfo_ssu_attr_ex(ssusysinfo_t *self, const char *sec, const char *key)
 {
     const char *res = 0;
-    if( self && self->ssu_ini )
-        res = inifile_get(self->ssu_ini, sec, key, 0);
+    if( self )
+        res = inifile_get(ssusysinfo_source_ini(self, SOURCE_SSU_CONFIG), sec, key, 0);
     /* Always return valid c-string */
     return res ?: ssusysinfo_unknown;
 }
@@ -965,21 +3205,21 @@ ssusysinfo_ssu_attr(ssusysinfo_t *self, const char *key)
 int
 ssusysinfo_ssu_config_version(ssusysinfo_t *self)
 {
-    const char *val = ssusysinfo_ssu_attr(self, "configVersion");
+    const char *val = ssusysinfo_probe_config_version(self);
     return (int)strtol(val, 0, 0);
 }
 
 bool
 ssusysinfo_ssu_registered(ssusysinfo_t *self)
 {
-    const char *val = ssusysinfo_ssu_attr(self, "registered");
+    const char *val = ssusysinfo_probe_registered(self);
     return !strcmp(val, "true");
 }
 
 ssu_device_mode_t
 ssusysinfo_ssu_device_mode(ssusysinfo_t *self)
 {
-    const char *val = ssusysinfo_ssu_attr(self, "deviceMode");
+    const char *val = ssusysinfo_probe_device_mode(self);
     return (ssu_device_mode_t)strtol(val, 0, 0);
 }
 
@@ -993,81 +3233,114 @@ ssusysinfo_ssu_in_rnd_mode(ssusysinfo_t *self)
 const char *
 ssusysinfo_ssu_arch(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_ARCH);
+
     return ssusysinfo_ssu_attr(self, "arch");
 }
 
 const char *
 ssusysinfo_ssu_brand(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_BRAND);
+
     return ssusysinfo_ssu_attr(self, "brand");
 }
 
 const char *
 ssusysinfo_ssu_flavour(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_FLAVOUR);
+
     return ssusysinfo_ssu_attr(self, "flavour");
 }
 
 const char *
 ssusysinfo_ssu_domain(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_DOMAIN);
+
     return ssusysinfo_ssu_attr(self, "domain");
 }
 
 const char *
 ssusysinfo_ssu_release(ssusysinfo_t *self)
 {
-    if( ssusysinfo_ssu_in_rnd_mode(self) )
-        return ssusysinfo_ssu_rnd_release(self);
-    return ssusysinfo_ssu_def_release(self);
+    /* Mode and release must come from the same set of values */
+    unsigned    token = ssusysinfo_read_begin(self);
+    const char *res   = (ssusysinfo_ssu_in_rnd_mode(self) ?
+                         ssusysinfo_ssu_rnd_release(self) :
+                         ssusysinfo_ssu_def_release(self));
+    ssusysinfo_read_end(self, token);
+    return res;
 }
 
 const char *
 ssusysinfo_ssu_def_release(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_DEF_RELEASE);
+
     return ssusysinfo_ssu_attr(self, "release");
 }
 
 const char *
 ssusysinfo_ssu_rnd_release(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_RND_RELEASE);
+
     return ssusysinfo_ssu_attr(self, "rndRelease");
 }
 
 const char *
 ssusysinfo_ssu_enabled_repos(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_ENABLED_REPOS);
+
     return ssusysinfo_ssu_attr(self, "enabled-repos");
 }
 
 const char *
 ssusysinfo_ssu_disabled_repos(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_DISABLED_REPOS);
+
     return ssusysinfo_ssu_attr(self, "disabled-repos");
 }
 
 const char *
 ssusysinfo_ssu_last_credentials_update(ssusysinfo_t *self)
 {
-    const char key[] = "lastCredentialsUpdate";
+    const char *key    = ssusysinfo_cached_lut[CACHED_LAST_CREDENTIALS_UPDATE].key;
     const char *cached = 0;
 
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_LAST_CREDENTIALS_UPDATE);
+
     /* We need to demangle DateTime formatting. While the
      * process does not take that much cpu time, caching the
      * result yields the same lifetime and constness for the
      * returned data as what the more direct lookups have.
      */
 
-    if( (cached = inifile_get(self->cfg_ini, "cached-values", key, 0)) )
+    if( !self )
+        goto EXIT;
+
+    if( (cached = self->cached[CACHED_LAST_CREDENTIALS_UPDATE]) )
         goto EXIT;
 
     const char *datetime = ssusysinfo_ssu_attr(self, key);
     char *probed = qtdecoder_parse_datetime(datetime);
-    inifile_set(self->cfg_ini, "cached-values", key, probed ?: datetime);
+    cached = ssusysinfo_cache_set(self, CACHED_LAST_CREDENTIALS_UPDATE,
+                                  probed ?: datetime);
     free(probed);
 
-    cached = inifile_get(self->cfg_ini, "cached-values", key, 0);
-
 EXIT:
     return cached ?: ssusysinfo_unknown;
 }
@@ -1075,6 +3348,9 @@ EXIT:
 const char *
 ssusysinfo_ssu_credentials_scope(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_SCOPE);
+
     return ssusysinfo_ssu_attr(self, "credentials-scope");
 }
 
@@ -1094,12 +3370,18 @@ ssusysinfo_ssu_credentials_url(ssusysinfo_t *self, const char *scope)
 const char *
 ssusysinfo_ssu_credentials_url_jolla(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_URL_JOLLA);
+
     return ssusysinfo_ssu_credentials_url(self, "jolla");
 }
 
 const char *
 ssusysinfo_ssu_credentials_url_store(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_URL_STORE);
+
     return ssusysinfo_ssu_credentials_url(self, "store");
 }
 
@@ -1135,6 +3417,9 @@ ssusysinfo_ssu_credentials_username(ssusysinfo_t *self, const char *scope)
 const char *
 ssusysinfo_ssu_credentials_username_jolla(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_USERNAME_JOLLA);
+
     return ssusysinfo_ssu_credentials_username(self, "jolla");
 }
 
@@ -1147,6 +3432,9 @@ ssusysinfo_ssu_credentials_username_jolla(ssusysinfo_t *self)
 const char *
 ssusysinfo_ssu_credentials_username_store(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_USERNAME_STORE);
+
     return ssusysinfo_ssu_credentials_username(self, "store");
 }
 
@@ -1172,6 +3460,9 @@ ssusysinfo_ssu_credentials_password(ssusysinfo_t *self, const char *scope)
 const char *
 ssusysinfo_ssu_credentials_password_jolla(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_PASSWORD_JOLLA);
+
     return ssusysinfo_ssu_credentials_password(self, "jolla");
 }
 
@@ -1184,6 +3475,9 @@ ssusysinfo_ssu_credentials_password_jolla(ssusysinfo_t *self)
 const char *
 ssusysinfo_ssu_credentials_password_store(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIALS_PASSWORD_STORE);
+
     return ssusysinfo_ssu_credentials_password(self, "store");
 }
 
@@ -1196,16 +3490,22 @@ ssusysinfo_ssu_credentials_password_store(ssusysinfo_t *self)
 const char *
 ssusysinfo_ssu_certificate(ssusysinfo_t *self)
 {
-    const char key[] = "certificate";
+    const char *key    = ssusysinfo_cached_lut[CACHED_CERTIFICATE].key;
     const char *cached = 0;
 
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CERTIFICATE);
+
     /* We need to demangle ByteArray formatting. While the
      * process does not take that much cpu time, caching the
      * result yields the same lifetime and constness for the
      * returned data as what the more direct lookups have.
      */
 
-    if( (cached = inifile_get(self->cfg_ini, "cached-values", key, 0)) )
+    if( !self )
+        goto EXIT;
+
+    if( (cached = self->cached[CACHED_CERTIFICATE]) )
         goto EXIT;
 
     const char *bytearray = ssusysinfo_ssu_attr(self, key);
@@ -1213,11 +3513,9 @@ ssusysinfo_ssu_certificate(ssusysinfo_t *self)
     char *probed = qtdecoder_parse_bytearray(bytearray, &length);
     if( probed && strlen(probed) != length )
         log_warning("%s: has embedded NUL chars", key);
-    inifile_set(self->cfg_ini, "cached-values", key, probed ?: bytearray);
+    cached = ssusysinfo_cache_set(self, CACHED_CERTIFICATE, probed ?: bytearray);
     free(probed);
 
-    cached = inifile_get(self->cfg_ini, "cached-values", key, 0);
-
 EXIT:
     return cached ?: ssusysinfo_unknown;
 }
@@ -1231,16 +3529,22 @@ EXIT:
 const char *
 ssusysinfo_ssu_private_key(ssusysinfo_t *self)
 {
-    const char key[] = "privateKey";
+    const char *key    = ssusysinfo_cached_lut[CACHED_PRIVATE_KEY].key;
     const char *cached = 0;
 
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_PRIVATE_KEY);
+
     /* We need to demangle ByteArray formatting. While the
      * process does not take that much cpu time, caching the
      * result yields the same lifetime and constness for the
      * returned data as what the more direct lookups have.
      */
 
-    if( (cached = inifile_get(self->cfg_ini, "cached-values", key, 0)) )
+    if( !self )
+        goto EXIT;
+
+    if( (cached = self->cached[CACHED_PRIVATE_KEY]) )
         goto EXIT;
 
     const char *bytearray = ssusysinfo_ssu_attr(self, key);
@@ -1248,11 +3552,9 @@ ssusysinfo_ssu_private_key(ssusysinfo_t *self)
     char *probed = qtdecoder_parse_bytearray(bytearray, &length);
     if( probed && strlen(probed) != length )
         log_warning("%s: has embedded NUL chars", key);
-    inifile_set(self->cfg_ini, "cached-values", key, probed ?: bytearray);
+    cached = ssusysinfo_cache_set(self, CACHED_PRIVATE_KEY, probed ?: bytearray);
     free(probed);
 
-    cached = inifile_get(self->cfg_ini, "cached-values", key, 0);
-
 EXIT:
     return cached ?: ssusysinfo_unknown;
 }
@@ -1261,12 +3563,18 @@ EXIT:
 const char *
 ssusysinfo_ssu_default_rnd_domain(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_DEFAULT_RND_DOMAIN);
+
     return ssusysinfo_ssu_attr(self, "default-rnd-domain");
 }
 
 const char *
 ssusysinfo_ssu_home_url(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_HOME_URL);
+
     return ssusysinfo_ssu_attr(self, "home-url");
 }
 
@@ -1275,10 +3583,13 @@ ssusysinfo_os_name(ssusysinfo_t *self)
 {
     const char *res = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_OS_NAME);
+
+    if( !self )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, OS_RELEASE_SECTION, "NAME", 0);
+    res = ssusysinfo_release_get(self, OS_RELEASE_SECTION, "NAME");
 
 EXIT:
     return res ?: ssusysinfo_unknown;
@@ -1289,10 +3600,13 @@ ssusysinfo_os_version(ssusysinfo_t *self)
 {
     const char *res = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_OS_VERSION);
+
+    if( !self )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, OS_RELEASE_SECTION, "VERSION_ID", 0);
+    res = ssusysinfo_release_get(self, OS_RELEASE_SECTION, "VERSION_ID");
 
 EXIT:
     return res ?: ssusysinfo_unknown;
@@ -1303,10 +3617,13 @@ ssusysinfo_os_pretty_version(ssusysinfo_t *self)
 {
     const char *res = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_OS_PRETTY_VERSION);
+
+    if( !self )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, OS_RELEASE_SECTION, "VERSION", 0);
+    res = ssusysinfo_release_get(self, OS_RELEASE_SECTION, "VERSION");
 
 EXIT:
     return res ?: ssusysinfo_unknown;
@@ -1317,10 +3634,13 @@ ssusysinfo_hw_version(ssusysinfo_t *self)
 {
     const char *res = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_HW_VERSION);
+
+    if( !self )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, HW_RELEASE_SECTION, "VERSION_ID", 0);
+    res = ssusysinfo_release_get(self, HW_RELEASE_SECTION, "VERSION_ID");
 
 EXIT:
     return res ?: ssusysinfo_unknown;
@@ -1331,10 +3651,13 @@ ssusysinfo_hw_pretty_version(ssusysinfo_t *self)
 {
     const char *res = 0;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_HW_PRETTY_VERSION);
+
+    if( !self )
         goto EXIT;
 
-    res = inifile_get(self->cfg_ini, HW_RELEASE_SECTION, "VERSION", 0);
+    res = ssusysinfo_release_get(self, HW_RELEASE_SECTION, "VERSION");
 
 EXIT:
     return res ?: ssusysinfo_unknown;
@@ -1344,23 +3667,27 @@ const char *
 ssusysinfo_board_version(ssusysinfo_t *self)
 {
     static const char path[] = "/sys/firmware/devicetree/base/model";
-    static const char sec[]  = "cached-values";
-    static const char key[]  = "BOARD_VERSION";
 
     const char *cached = NULL;
 
-    if( !self || !self->cfg_ini )
+    if( ssusysinfo_is_shared(self) ) {
+        unsigned token = ssusysinfo_read_begin(self);
+        cached = ssusysinfo_resolved(self)->board_version;
+        ssusysinfo_read_end(self, token);
+        goto EXIT;
+    }
+
+    if( !self )
         goto EXIT;
 
-    if( !(cached = inifile_get(self->cfg_ini, sec, key, NULL)) ) {
+    if( !(cached = self->cached[CACHED_BOARD_VERSION]) ) {
         char *probed = NULL;
         if( fileutil_exists(path) ) {
             if( (probed = fileutil_read(path, NULL)) )
                 strutil_trim(probed);
         }
-        inifile_set(self->cfg_ini, sec, key,
-                    probed && *probed ? probed : ssusysinfo_unknown);
-        cached = inifile_get(self->cfg_ini, sec, key, NULL);
+        cached = ssusysinfo_cache_set(self, CACHED_BOARD_VERSION,
+                                      probed && *probed ? probed : ssusysinfo_unknown);
         free(probed);
     }
 
@@ -1390,7 +3717,7 @@ bool
 ssusysinfo_ssu_initialized(ssusysinfo_t *self)
 {
     /* XXX: Not used in SSU - leftover legacy fluff? */
-    const char *val = ssusysinfo_ssu_attr(self, "initialized");
+    const char *val = ssusysinfo_probe_initialized(self);
     return !strcmp(val, "true");
 }
 
@@ -1408,7 +3735,7 @@ int
 ssusysinfo_ssu_credentials_ttl(ssusysinfo_t *self)
 {
     /* XXX: Not used in SSU - leftover legacy fluff? */
-    const char *val = ssusysinfo_ssu_attr(self, "credentials-ttl");
+    const char *val = ssusysinfo_probe_credentials_ttl(self);
     return strtol(val, 0, 0);
 }
 
@@ -1425,6 +3752,9 @@ ssusysinfo_ssu_credentials_ttl(ssusysinfo_t *self)
 const char *
 ssusysinfo_ssu_credential_scopes(ssusysinfo_t *self)
 {
+    if( ssusysinfo_is_shared(self) )
+        return ssusysinfo_shared_value(self, PROBE_SSU_CREDENTIAL_SCOPES);
+
     /* XXX: Only written in SSU - leftover legacy fluff? */
     return ssusysinfo_ssu_attr(self, "credentialScopes");
 }
@@ -1447,24 +3777,41 @@ ssusysinfo_hw_feature_from_name(const char *name)
     return hw_feature_from_string(name);
 }
 
+uint64_t
+ssusysinfo_hw_feature_mask(ssusysinfo_t *self)
+{
+    uint64_t mask = 0;
+
+    if( !self )
+        goto EXIT;
+
+    if( ssusysinfo_is_shared(self) ) {
+        unsigned token = ssusysinfo_read_begin(self);
+        mask = ssusysinfo_resolved(self)->fields.features;
+        ssusysinfo_read_end(self, token);
+        goto EXIT;
+    }
+
+    if( !self->feature_mask_valid ) {
+        self->feature_mask       = ssusysinfo_evaluate_feature_mask(self);
+        self->feature_mask_valid = true;
+    }
+
+    mask = self->feature_mask;
+
+EXIT:
+    return mask;
+}
+
 bool
 ssusysinfo_has_hw_feature(ssusysinfo_t *self, hw_feature_t id)
 {
     bool supported = false;
 
-    if( !self || !self->cfg_ini )
-        goto EXIT;
-
     if( !hw_feature_is_valid(id) )
         goto EXIT;
 
-    const char *key = hw_feature_to_csd_key(id);
-    const char *val = inifile_get(self->cfg_ini, "features", key, 0);
-
-    if( val )
-        supported = (strtol(val, 0, 0) != 0);
-    else
-        supported = hw_feature_get_fallback(id);
+    supported = (ssusysinfo_hw_feature_mask(self) >> id) & 1;
 
 EXIT:
     return supported;
@@ -1476,13 +3823,15 @@ ssusysinfo_get_hw_features(ssusysinfo_t *self)
     hw_feature_t *data = 0;
     size_t        used = 0;
 
-    if( !self || !self->cfg_ini )
+    if( !self )
         goto EXIT;
 
     data = xcalloc(Feature_Count, sizeof *data);
 
+    uint64_t mask = ssusysinfo_hw_feature_mask(self);
+
     for( hw_feature_t id = Feature_Invalid + 1; id < Feature_Count; ++id ) {
-        if( ssusysinfo_has_hw_feature(self, id) )
+        if( (mask >> id) & 1 )
             data[used++] = id;
     }
     data[used] = Feature_Invalid;
@@ -1497,6 +3846,18 @@ ssusysinfo_hw_feature_names(void)
     return hw_feature_names();
 }
 
+const char * const *
+ssusysinfo_hw_feature_name_list(void)
+{
+    return hw_feature_name_list();
+}
+
+size_t
+ssusysinfo_hw_feature_name_count(void)
+{
+    return hw_feature_name_count();
+}
+
 /* ------------------------------------------------------------------------- *
  * HW Keys
  * ------------------------------------------------------------------------- */
@@ -1518,10 +3879,24 @@ ssusysinfo_get_hw_keys(ssusysinfo_t *self)
 {
     hw_key_t *data = 0;
 
-    if( !self || !self->cfg_ini )
+    if( !self )
+        goto EXIT;
+
+    if( ssusysinfo_is_shared(self) ) {
+        unsigned token = ssusysinfo_read_begin(self);
+        const ssusysinfo_resolved_t *res = ssusysinfo_resolved(self);
+        /* Keep returning NULL when keys are not configured at all */
+        if( res->keys_configured )
+            data = hw_key_set_array(&res->keys);
+        ssusysinfo_read_end(self, token);
+        goto EXIT;
+    }
+
+    /* Keep returning NULL when keys are not configured at all */
+    if( !ssusysinfo_cfg_get(self, "Keys", "Keys") )
         goto EXIT;
 
-    data = hw_key_parse_array(inifile_get(self->cfg_ini, "Keys", "Keys", 0));
+    data = hw_key_set_array(ssusysinfo_hw_key_set(self));
 
 EXIT:
     return data;
@@ -1532,24 +3907,19 @@ ssusysinfo_has_hw_key(ssusysinfo_t *self, hw_key_t code)
 {
     bool supported = false;
 
-    hw_key_t *keys = 0;
-
-    if( !hw_key_is_valid(code) )
+    if( !self || !hw_key_is_valid(code) )
         goto EXIT;
 
-    if( !(keys = ssusysinfo_get_hw_keys(self)) )
+    if( ssusysinfo_is_shared(self) ) {
+        unsigned token = ssusysinfo_read_begin(self);
+        supported = hw_key_set_has(&ssusysinfo_resolved(self)->keys, code);
+        ssusysinfo_read_end(self, token);
         goto EXIT;
-
-    for( size_t i = 0; keys[i]; ++i ) {
-        if( keys[i] == code ) {
-            supported = true;
-            break;
-        }
     }
 
-EXIT:
-    free(keys);
+    supported = hw_key_set_has(ssusysinfo_hw_key_set(self), code);
 
+EXIT:
     return supported;
 }
 
@@ -1558,3 +3928,15 @@ ssusysinfo_hw_key_names(void)
 {
     return hw_key_names();
 }
+
+const char * const *
+ssusysinfo_hw_key_name_list(void)
+{
+    return hw_key_name_list();
+}
+
+size_t
+ssusysinfo_hw_key_name_count(void)
+{
+    return hw_key_name_count();
+}
@@ -25,6 +25,7 @@
 # define SSUSYSINFO_H_
 
 # include <stdbool.h>
+# include <stddef.h>
 # include <stdint.h>
 
 # ifdef __cplusplus
@@ -68,6 +69,56 @@ typedef enum  {
     SSU_DEVICE_MODE_APP_INSTALL          = 1<<5,
 } ssu_device_mode_t;
 
+/** Logical field bits used in change notifications
+ *
+ * @since ssu-sysinfo 1.6.0
+ */
+typedef enum  {
+    /** Device model and base model */
+    SSUSYSINFO_FIELD_DEVICE_MODEL        = 1<<0,
+    /** Device designation, manufacturer and pretty name */
+    SSUSYSINFO_FIELD_DEVICE_ATTRS        = 1<<1,
+    /** SSU registration status */
+    SSUSYSINFO_FIELD_SSU_REGISTERED      = 1<<2,
+    /** SSU device mode */
+    SSUSYSINFO_FIELD_SSU_DEVICE_MODE     = 1<<3,
+    /** SSU architecture */
+    SSUSYSINFO_FIELD_SSU_ARCH            = 1<<4,
+    /** SSU brand */
+    SSUSYSINFO_FIELD_SSU_BRAND           = 1<<5,
+    /** SSU flavour */
+    SSUSYSINFO_FIELD_SSU_FLAVOUR         = 1<<6,
+    /** SSU domain */
+    SSUSYSINFO_FIELD_SSU_DOMAIN          = 1<<7,
+    /** SSU release, default release and rnd release */
+    SSUSYSINFO_FIELD_SSU_RELEASE         = 1<<8,
+    /** SSU enabled and disabled repositories */
+    SSUSYSINFO_FIELD_SSU_REPOS           = 1<<9,
+    /** SSU credentials scope, urls and update time */
+    SSUSYSINFO_FIELD_SSU_CREDENTIALS     = 1<<10,
+    /** Other SSU settings: config version, home url, rnd domain */
+    SSUSYSINFO_FIELD_SSU_OTHER           = 1<<11,
+    /** OS name and version */
+    SSUSYSINFO_FIELD_OS_RELEASE          = 1<<12,
+    /** HW version */
+    SSUSYSINFO_FIELD_HW_RELEASE          = 1<<13,
+    /** Supported hw features */
+    SSUSYSINFO_FIELD_HW_FEATURES         = 1<<14,
+    /** Supported hw keys */
+    SSUSYSINFO_FIELD_HW_KEYS             = 1<<15,
+} ssusysinfo_field_t;
+
+/** Callback for reporting configuration changes
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * @param self     ssusysinfo object pointer
+ * @param changed  bitmask of #ssusysinfo_field_t values
+ * @param aptr     user data pointer given to #ssusysinfo_set_change_cb()
+ */
+typedef void (*ssusysinfo_change_cb)(ssusysinfo_t *self, unsigned changed,
+                                     void *aptr);
+
 /* ========================================================================= *
  * FUNCTIONS
  * ========================================================================= */
@@ -81,10 +132,43 @@ typedef enum  {
  * Parses SSU configuration files and returns handle
  * that can be used for querying values.
  *
+ * If an up to date snapshot written by #ssusysinfo_write_snapshot()
+ * exists, it is used instead and no parsing is needed.
+ *
  * @return ssusysinfo object pointer
  */
 ssusysinfo_t *ssusysinfo_create             (void);
 
+/** Create SSU configuration object that can be shared between threads
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Objects created with #ssusysinfo_create() are not thread safe, as
+ * even queries update internal state: configuration files are loaded
+ * and derived values cached on first use.
+ *
+ * Handles created with this function resolve all values on first
+ * query, and serve further queries from an immutable set of values
+ * without locking. The #ssusysinfo_reload(), #ssusysinfo_refresh()
+ * and #ssusysinfo_process_events() functions are serialized and
+ * publish a new set of values atomically.
+ *
+ * Replaced values are released only after all readers that might
+ * be using them are gone. Queries made between #ssusysinfo_read_begin()
+ * and #ssusysinfo_read_end() all see the same set of values, and the
+ * strings they return remain valid until the read section ends,
+ * regardless of reloads made by other threads. Strings returned by
+ * queries made outside read sections remain valid until a reload
+ * changes the value in question - after that they can be released
+ * at any time, so callers holding on to them for longer must use
+ * a read section or make a copy.
+ *
+ * Deleting the handle must not overlap with any other use.
+ *
+ * @return ssusysinfo object pointer
+ */
+ssusysinfo_t *ssusysinfo_create_threadsafe  (void);
+
 /** Delete SSU configuration object
  *
  * @param self ssusysinfo object pointer, or NULL
@@ -97,12 +181,238 @@ void          ssusysinfo_delete             (ssusysinfo_t *self);
  */
 void          ssusysinfo_delete_cb          (void *self);
 
+/** Get reference to process wide SSU configuration object
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Libraries and components that are loaded into the same process
+ * can use this instead of #ssusysinfo_create(), so that configuration
+ * files are parsed and values resolved only once per process.
+ *
+ * The object is created on first use, as if by
+ * #ssusysinfo_create_threadsafe(), and can be used from any thread.
+ * As the object is shared, changing the change callback via
+ * #ssusysinfo_set_change_cb() affects all users - components that
+ * need change notifications should use an object of their own.
+ *
+ * @return ssusysinfo object pointer, to be released with
+ *         #ssusysinfo_release()
+ */
+ssusysinfo_t *ssusysinfo_acquire            (void);
+
+/** Release reference to process wide SSU configuration object
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * The object is deleted when the last reference is released. Calling
+ * #ssusysinfo_delete() on the process wide object has the same effect.
+ *
+ * @param self ssusysinfo object pointer from #ssusysinfo_acquire(),
+ *             or NULL
+ */
+void          ssusysinfo_release            (ssusysinfo_t *self);
+
 /** Force realoading of SSU configuration files
+ *
+ * For handles created with #ssusysinfo_create(), all strings returned
+ * by earlier queries are invalidated. See #ssusysinfo_create_threadsafe()
+ * for handles that can be reloaded while strings are in use.
  *
  * @param self ssusysinfo object pointer
  */
 void          ssusysinfo_reload             (ssusysinfo_t *self);
 
+/** Reload SSU configuration files that have changed
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Checks device, inode, size, modification and change time of
+ * all loaded files, and of the directories that were scanned for
+ * configuration files, and re-parses only the sources that have
+ * changed. If nothing has changed, no files are read and values
+ * returned by earlier queries remain valid.
+ *
+ * Intended as a cheap alternative to #ssusysinfo_reload() for
+ * long running processes.
+ *
+ * @param self ssusysinfo object pointer
+ */
+void          ssusysinfo_refresh            (ssusysinfo_t *self);
+
+/** Get file descriptor for watching SSU configuration changes
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Returns non-blocking inotify file descriptor that becomes readable
+ * when any of the loaded configuration files, or directories scanned
+ * for configuration files, change. It can be added to any main loop,
+ * and #ssusysinfo_process_events() should be called when it becomes
+ * readable.
+ *
+ * The file descriptor is owned by the ssusysinfo object and remains
+ * the same for the lifetime of the object.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return file descriptor, or -1 on failure
+ */
+int           ssusysinfo_get_watch_fd       (ssusysinfo_t *self);
+
+/** Handle pending configuration change events
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Reloads only the configuration sources that have changed, as with
+ * #ssusysinfo_refresh(), and determines which logical fields got
+ * different values. If any did, the change callback is notified.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return bitmask of changed #ssusysinfo_field_t values
+ */
+unsigned      ssusysinfo_process_events     (ssusysinfo_t *self);
+
+/** Set callback for configuration change notifications
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * The callback is invoked from #ssusysinfo_process_events().
+ *
+ * @param self ssusysinfo object pointer
+ * @param cb   callback function, or NULL to remove
+ * @param aptr user data pointer to pass to the callback
+ */
+void          ssusysinfo_set_change_cb      (ssusysinfo_t *self,
+                                             ssusysinfo_change_cb cb,
+                                             void *aptr);
+
+/** Enter a read section
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * All queries made by the calling thread within a read section of a
+ * handle created with #ssusysinfo_create_threadsafe() see the set of
+ * values that was current when the outermost section was entered,
+ * and the values are not released before the section is left via
+ * #ssusysinfo_read_end(). This allows combining several values and
+ * using returned strings without making copies even while other
+ * threads are reloading configuration. Read sections never block,
+ * and can be nested.
+ *
+ * A thread can have read sections open on up to four handles at the
+ * same time; beyond that, queries still return valid strings, but are
+ * not guaranteed to see the same set of values.
+ *
+ * Read sections should be short lived, as values replaced during
+ * them are kept in memory until the section ends.
+ *
+ * For regular handles this is a no-op.
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return token to pass to #ssusysinfo_read_end()
+ */
+unsigned      ssusysinfo_read_begin         (ssusysinfo_t *self);
+
+/** Leave a read section
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * After this, strings obtained within the read section must not
+ * be used.
+ *
+ * @param self  ssusysinfo object pointer
+ * @param token value returned by #ssusysinfo_read_begin()
+ */
+void          ssusysinfo_read_end           (ssusysinfo_t *self,
+                                             unsigned token);
+
+/** Compile board mapping files into a database
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Merges /usr/share/ssu/board-mappings.d/\*.ini files and stores
+ * the result in a binary form that ssusysinfo_create() can use
+ * without parsing anything. The database is used only while it
+ * is up to date with the board mapping files.
+ *
+ * The database file is replaced atomically.
+ *
+ * @param path  database path, or NULL to use the default location
+ *
+ * @return true on success, false otherwise
+ */
+bool ssusysinfo_compile_board_mappings(const char *path);
+
+/** Write snapshot of fully resolved values
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Resolves device model and attributes, hw features and keys,
+ * os / hw release data and ssu settings, and stores them in a
+ * binary form that ssusysinfo_create() maps instead of loading
+ * the configuration files and repeating model detection.
+ *
+ * Credentials are not included, the snapshot is world readable.
+ * Model detection rules are, so that #ssusysinfo_explain_device_model()
+ * reports the same steps with and without a snapshot.
+ *
+ * Paths and modification times of the source files are stored
+ * too, and the snapshot is ignored when it is not up to date.
+ * The file is replaced atomically.
+ *
+ * @param path  snapshot path, or NULL to use the default location
+ *              i.e. /run/ssu-sysinfo/snapshot.db
+ *
+ * @return true on success, false otherwise
+ */
+bool ssusysinfo_write_snapshot(const char *path);
+
+/** Callback for streaming ini file parsing
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * The strings are valid only for the duration of the callback.
+ *
+ * @param sec   section name
+ * @param key   key name
+ * @param val   value
+ * @param aptr  user data pointer given to #ssusysinfo_scan_ini()
+ *
+ * @return true to continue parsing, or false to stop
+ */
+typedef bool (*ssusysinfo_ini_cb)(const char *sec, const char *key,
+                                  const char *val, void *aptr);
+
+/** Parse ini file without storing the content
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Intended for tools that need only few values from files such
+ * as /etc/ssu/ssu.ini. The callback is invoked for each key-value
+ * entry in file order, i.e. if a key occurs more than once in a
+ * section, the last value is the one ssusysinfo_create() would use.
+ *
+ * Parsing rules are the same as what the library uses internally.
+ * If default section is given, entries before the first section
+ * header are reported in it and quotes around values are removed -
+ * as is suitable for files like /etc/os-release.
+ *
+ * The file is read into a temporary buffer that is released before
+ * returning, but no values are stored and no config objects are
+ * created.
+ *
+ * @param path    path to ini file
+ * @param defsec  default section name, or NULL
+ * @param cb      callback to invoke for each entry
+ * @param aptr    user data pointer to pass to the callback
+ *
+ * @return 0 if the whole file was parsed, 1 if callback stopped
+ *         parsing, or -1 if the file could not be read
+ */
+int ssusysinfo_scan_ini(const char *path, const char *defsec,
+                        ssusysinfo_ini_cb cb, void *aptr);
+
 /** Query device model
  *
  * Try to find out ond what kind of system this is running.
@@ -128,6 +438,55 @@ void          ssusysinfo_reload             (ssusysinfo_t *self);
  */
 const char   *ssusysinfo_device_model       (ssusysinfo_t *self);
 
+/** Report about evaluation of a device model detection rule
+ *
+ * @since ssu-sysinfo 1.6.0
+ */
+typedef struct
+{
+    /** Rule type: "file.exists", "hw-release" or "cpuinfo.contains" */
+    const char *rule;
+    /** Path, hw-release key or cpuinfo pattern checked by the rule */
+    const char *value;
+    /** Model the rule yields when matched, or NULL if not known */
+    const char *model;
+    /** True if the rule matched */
+    bool        matched;
+    /** Time spent evaluating the rule, in nanoseconds */
+    uint64_t    nsec;
+} ssusysinfo_model_rule_t;
+
+/** Callback for reporting device model detection rules
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * @param rule  evaluated rule, valid only during the callback
+ * @param aptr  user data pointer given to #ssusysinfo_explain_device_model()
+ */
+typedef void (*ssusysinfo_model_rule_cb)(const ssusysinfo_model_rule_t *rule,
+                                         void *aptr);
+
+/** Explain how device model is determined
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Evaluates device model detection rules like #ssusysinfo_device_model()
+ * does, but without using cached values, and reports each evaluated
+ * rule in order of precedence. Evaluation stops at the first matching
+ * rule; if no rule matches, the model is "UNKNOWN".
+ *
+ * Rules matching /proc/cpuinfo content are checked in one pass; the
+ * time it takes is attributed to the first of them.
+ *
+ * The callback must not use the ssusysinfo object.
+ *
+ * @param self ssusysinfo object pointer
+ * @param cb   callback function
+ * @param aptr user data pointer to pass to the callback
+ */
+void ssusysinfo_explain_device_model(ssusysinfo_t *self,
+                                     ssusysinfo_model_rule_cb cb, void *aptr);
+
 /** Query device base model
  *
  * For variant devices #ssusysinfo_device_model() returns the
@@ -658,6 +1017,18 @@ hw_feature_t *ssusysinfo_get_hw_features(ssusysinfo_t *self);
  */
 bool ssusysinfo_has_hw_feature(ssusysinfo_t *self, hw_feature_t id);
 
+/** Get mask of supported hw features
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Allocation free alternative to #ssusysinfo_get_hw_features().
+ *
+ * @param self ssusysinfo object pointer
+ *
+ * @return bitmask with bit N set if hw feature N is supported
+ */
+uint64_t ssusysinfo_hw_feature_mask(ssusysinfo_t *self);
+
 /** Convert hw feature enum value to string
  *
  * @param id  hw feature enum value
@@ -683,6 +1054,25 @@ hw_feature_t ssusysinfo_hw_feature_from_name(const char *name);
  */
 const char **ssusysinfo_hw_feature_names(void);
 
+/** Get static array of hw feature names
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Allocation free alternative to #ssusysinfo_hw_feature_names().
+ * The array is owned by the library and must not be released.
+ *
+ * @return NULL terminated array of names
+ */
+const char * const *ssusysinfo_hw_feature_name_list(void);
+
+/** Get number of hw feature names
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * @return number of names in #ssusysinfo_hw_feature_name_list() array
+ */
+size_t ssusysinfo_hw_feature_name_count(void);
+
 /** HW keys/buttons present on the device
  *
  * The original and primary use for the hw key configuration is
@@ -743,6 +1133,25 @@ hw_key_t ssusysinfo_hw_key_from_name(const char *name);
  */
 const char **ssusysinfo_hw_key_names(void);
 
+/** Get static array of hw key names
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * Allocation free alternative to #ssusysinfo_hw_key_names().
+ * The array is owned by the library and must not be released.
+ *
+ * @return NULL terminated array of names
+ */
+const char * const *ssusysinfo_hw_key_name_list(void);
+
+/** Get number of hw key names
+ *
+ * @since ssu-sysinfo 1.6.0
+ *
+ * @return number of names in #ssusysinfo_hw_key_name_list() array
+ */
+size_t ssusysinfo_hw_key_name_count(void);
+
 # pragma GCC visibility pop
 
 # ifdef __cplusplus
@@ -40,6 +40,139 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* ========================================================================= *
+ * symtab_t  --  internal helpers
+ * ========================================================================= */
+
+/* ------------------------------------------------------------------------- *
+ * symtab_hash  --  FNV-1a hash of a key string
+ * ------------------------------------------------------------------------- */
+
+static size_t
+symtab_hash(const char *key)
+{
+  size_t h = (size_t)2166136261u;
+
+  for( const unsigned char *s = (const unsigned char *)key; *s; ++s )
+  {
+    h ^= *s;
+    h *= (size_t)16777619u;
+  }
+
+  return h;
+}
+
+/* ------------------------------------------------------------------------- *
+ * symtab_alloc  --  allocate array memory from arena or heap
+ * ------------------------------------------------------------------------- */
+
+static void *
+symtab_alloc(symtab_t *self, void *old, size_t old_size, size_t new_size)
+{
+  void *res;
+
+  if( self->st_arena_pvt == 0 )
+    return xrealloc(old, new_size);
+
+  /* Arena memory is never released piecemeal, the old array is
+   * simply left behind */
+  res = arena_alloc(self->st_arena_pvt, new_size);
+  if( old_size > 0 )
+    memcpy(res, old, old_size);
+  return res;
+}
+
+/* ------------------------------------------------------------------------- *
+ * symtab_probe  --  locate slot holding key, or empty slot for it
+ * ------------------------------------------------------------------------- */
+
+static symtab_slot_t *
+symtab_probe(const symtab_t *self, const char *key, size_t hash)
+{
+  size_t mask = self->st_slots_pvt - 1;
+
+  for( size_t i = hash & mask; ; i = (i + 1) & mask )
+  {
+    symtab_slot_t *slot = &self->st_index_pvt[i];
+
+    if( slot->ss_elem == 0 )
+      return slot;
+
+    if( slot->ss_hash == hash &&
+        !strcmp(self->st_key_pvt(slot->ss_elem), key) )
+      return slot;
+  }
+}
+
+/* ------------------------------------------------------------------------- *
+ * symtab_rehash  --  grow hash index so that load factor stays below 1/2
+ * ------------------------------------------------------------------------- */
+
+static void
+symtab_rehash(symtab_t *self, size_t need)
+{
+  size_t         slots = self->st_slots_pvt ?: 32;
+  symtab_slot_t *index = self->st_index_pvt;
+  size_t         nold  = self->st_slots_pvt;
+
+  while( slots < need * 2 )
+    slots *= 2;
+
+  if( slots == self->st_slots_pvt )
+    return;
+
+  self->st_slots_pvt = slots;
+  self->st_index_pvt = symtab_alloc(self, 0, 0, slots * sizeof *index);
+  memset(self->st_index_pvt, 0, slots * sizeof *index);
+
+  /* Cached hashes make rehashing independent of the key callback */
+  for( size_t i = 0; i < nold; ++i )
+  {
+    if( index[i].ss_elem == 0 )
+      continue;
+
+    size_t mask = slots - 1;
+    size_t k    = index[i].ss_hash & mask;
+
+    while( self->st_index_pvt[k].ss_elem != 0 )
+      k = (k + 1) & mask;
+
+    self->st_index_pvt[k] = index[i];
+  }
+
+  if( self->st_arena_pvt == 0 )
+    free(index);
+}
+
+/* ------------------------------------------------------------------------- *
+ * symtab_compare_cb  --  qsort_r callback for ordering elements by key
+ * ------------------------------------------------------------------------- */
+
+static int
+symtab_compare_cb(const void *pa, const void *pb, void *aptr)
+{
+  const symtab_t *self = aptr;
+  const void     *a    = *(void * const *)pa;
+  const void     *b    = *(void * const *)pb;
+
+  return strcmp(self->st_key_pvt(a), self->st_key_pvt(b));
+}
+
+/* ------------------------------------------------------------------------- *
+ * symtab_sort  --  bring elements to key order before iteration
+ * ------------------------------------------------------------------------- */
+
+static void
+symtab_sort(symtab_t *self)
+{
+  if( !self->st_sorted_pvt )
+  {
+    qsort_r(self->st_elem_pvt, self->st_count_pvt,
+            sizeof *self->st_elem_pvt, symtab_compare_cb, self);
+    self->st_sorted_pvt = 1;
+  }
+}
+
 /* ========================================================================= *
  * symtab_t  --  methods
  * ========================================================================= */
@@ -61,6 +194,11 @@ symtab_size(const symtab_t *self)
 void *
 symtab_elem(const symtab_t *self, size_t ind)
 {
+    /* Element order is not part of the logical state, so sorting
+     * on demand is done also via const handles */
+    if( !self->st_sorted_pvt )
+      symtab_sort((symtab_t *)self);
+
     return (ind < self->st_count_pvt) ? self->st_elem_pvt[ind] : 0;
 }
 
@@ -71,22 +209,19 @@ symtab_elem(const symtab_t *self, size_t ind)
 void *
 symtab_insert(symtab_t *self, const void *key)
 {
-  size_t l = 0;
-  size_t h = self->st_count_pvt;
+  size_t hash = symtab_hash(key);
 
-  while( l < h )
-  {
-    size_t i = (l + h) / 2;
-    void  *p = self->st_elem_pvt[i];
-    int    r = strcmp(self->st_key_pvt(p), key);
+  symtab_rehash(self, self->st_count_pvt + 1);
 
-    if( r < 0 ) { l = i + 1; continue; }
-    if( r > 0 ) { h = i + 0; continue; }
-    return p;
-  }
+  symtab_slot_t *slot = symtab_probe(self, key, hash);
+
+  if( slot->ss_elem != 0 )
+    return slot->ss_elem;
 
   if( self->st_count_pvt == self->st_alloc_pvt )
   {
+    size_t used = self->st_alloc_pvt * sizeof *self->st_elem_pvt;
+
     if( self->st_alloc_pvt < 16 )
     {
       self->st_alloc_pvt = 16;
@@ -95,16 +230,22 @@ symtab_insert(symtab_t *self, const void *key)
     {
       self->st_alloc_pvt = self->st_alloc_pvt * 3 / 2;
     }
-    self->st_elem_pvt = xrealloc(self->st_elem_pvt,
-                                 self->st_alloc_pvt * sizeof *self->st_elem_pvt);
+    self->st_elem_pvt = symtab_alloc(self, self->st_elem_pvt, used,
+                                     self->st_alloc_pvt * sizeof *self->st_elem_pvt);
   }
 
-  for( h = self->st_count_pvt++; h > l; --h )
+  slot->ss_hash = hash;
+  slot->ss_elem = self->st_new_pvt(self->st_aux_pvt, key);
+
+  /* Appending keeps the array sorted only if the new key is the largest */
+  if( self->st_count_pvt > 0 && self->st_sorted_pvt )
   {
-    self->st_elem_pvt[h] = self->st_elem_pvt[h-1];
+    void *last = self->st_elem_pvt[self->st_count_pvt - 1];
+    if( strcmp(self->st_key_pvt(last), key) > 0 )
+      self->st_sorted_pvt = 0;
   }
 
-  return self->st_elem_pvt[l] = self->st_new_pvt(key);
+  return self->st_elem_pvt[self->st_count_pvt++] = slot->ss_elem;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -114,21 +255,10 @@ symtab_insert(symtab_t *self, const void *key)
 void *
 symtab_lookup(const symtab_t *self, const void *key)
 {
-  size_t l = 0;
-  size_t h = self->st_count_pvt;
+  if( self->st_count_pvt == 0 )
+    return 0;
 
-  while( l < h )
-  {
-    size_t i = (l + h) / 2;
-    void  *p = self->st_elem_pvt[i];
-    int    r = strcmp(self->st_key_pvt(p), key);
-
-    if( r < 0 ) { l = i + 1; continue; }
-    if( r > 0 ) { h = i + 0; continue; }
-    return p;
-  }
-
-  return 0;
+  return symtab_probe(self, key, symtab_hash(key))->ss_elem;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -145,7 +275,14 @@ symtab_clear(symtab_t *self)
       self->st_del_pvt(self->st_elem_pvt[i]);
     }
   }
-  self->st_count_pvt = 0;
+  self->st_count_pvt  = 0;
+  self->st_sorted_pvt = 1;
+
+  if( self->st_index_pvt != 0 )
+  {
+    memset(self->st_index_pvt, 0,
+           self->st_slots_pvt * sizeof *self->st_index_pvt);
+  }
 }
 
 /* ------------------------------------------------------------------------- *
@@ -154,16 +291,23 @@ symtab_clear(symtab_t *self)
 
 void
 symtab_ctor(symtab_t *self,
+            arena_t *arena,
             symtab_new_fn new,
             symtab_del_fn del,
-            symtab_key_fn key)
+            symtab_key_fn key,
+            void *aux)
 {
-  self->st_count_pvt = 0;
-  self->st_alloc_pvt = 0;
-  self->st_elem_pvt  = 0;
-  self->st_new_pvt   = new;
-  self->st_key_pvt   = key;
-  self->st_del_pvt   = del;
+  self->st_count_pvt  = 0;
+  self->st_alloc_pvt  = 0;
+  self->st_elem_pvt   = 0;
+  self->st_sorted_pvt = 1;
+  self->st_slots_pvt  = 0;
+  self->st_index_pvt  = 0;
+  self->st_arena_pvt  = arena;
+  self->st_new_pvt    = new;
+  self->st_key_pvt    = key;
+  self->st_del_pvt    = del;
+  self->st_aux_pvt    = aux;
 }
 
 /* ------------------------------------------------------------------------- *
@@ -174,5 +318,10 @@ void
 symtab_dtor(symtab_t *self)
 {
   symtab_clear(self);
-  free(self->st_elem_pvt);
+
+  if( self->st_arena_pvt == 0 )
+  {
+    free(self->st_elem_pvt);
+    free(self->st_index_pvt);
+  }
 }
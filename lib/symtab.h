@@ -36,6 +36,8 @@
 #ifndef SYMTAB_H_
 # define SYMTAB_H_
 
+# include "arena.h"
+
 # include <stddef.h>
 
 # ifdef __cplusplus
@@ -44,25 +46,46 @@ extern "C" {
 } /* fool JED indentation ... */
 # endif
 
-typedef struct symtab_t symtab_t;
+typedef struct symtab_t      symtab_t;
+typedef struct symtab_slot_t symtab_slot_t;
 
-typedef void       *(*symtab_new_fn)(const char*);
+typedef void       *(*symtab_new_fn)(void*, const char*);
 typedef const char *(*symtab_key_fn)(const void*);
 typedef void        (*symtab_del_fn)(void*);
 
+/* ------------------------------------------------------------------------- *
+ * symtab_slot_t
+ * ------------------------------------------------------------------------- */
+
+struct symtab_slot_t
+{
+  size_t  ss_hash;
+  void   *ss_elem;
+};
+
 /* ------------------------------------------------------------------------- *
  * symtab_t
  * ------------------------------------------------------------------------- */
 
 struct symtab_t
 {
+  /* Elements in insertion order, sorted lazily on iteration */
   size_t  st_count_pvt;
   size_t  st_alloc_pvt;
   void  **st_elem_pvt;
+  int     st_sorted_pvt;
+
+  /* Open addressing hash index with cached key hashes */
+  size_t          st_slots_pvt;
+  symtab_slot_t  *st_index_pvt;
+
+  /* Optional arena for the arrays above */
+  arena_t       *st_arena_pvt;
 
   symtab_new_fn  st_new_pvt;
   symtab_del_fn  st_del_pvt;
   symtab_key_fn  st_key_pvt;
+  void          *st_aux_pvt;
 };
 
 size_t    symtab_size     (const symtab_t *self);
@@ -71,9 +94,11 @@ void     *symtab_insert   (symtab_t *self, const void *key);
 void     *symtab_lookup   (const symtab_t *self, const void *key);
 void      symtab_clear    (symtab_t *self);
 void      symtab_ctor     (symtab_t *self,
+                           arena_t *arena,
                            symtab_new_fn new,
                            symtab_del_fn del,
-                           symtab_key_fn key);
+                           symtab_key_fn key,
+                           void *aux);
 void      symtab_dtor     (symtab_t *self);
 
 # ifdef __cplusplus
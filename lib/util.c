@@ -49,6 +49,7 @@ int    strutil_equals(const char *s1, const char *s2);
 
 bool  fileutil_exists(const char *path);
 char *fileutil_read  (const char *path, size_t *psize);
+char *fileutil_read_fd(int fd, size_t *psize);
 
 /* ========================================================================= *
  * STRING UTILITIES
@@ -183,11 +184,8 @@ fileutil_exists(const char *path)
 char *
 fileutil_read(const char *path, size_t *psize)
 {
-    bool    ack  = false;
-    int     file = -1;
-    size_t  done = 0;
-    size_t  size = 0x1000;
-    char   *data = xmalloc(size);
+    char *data = 0;
+    int   file = -1;
 
     if( (file = open(path, O_RDONLY)) == -1 )
     {
@@ -195,17 +193,47 @@ fileutil_read(const char *path, size_t *psize)
             log_debug("%s: open: %m", path);
         else
             log_warning("%s: open: %m", path);
-        goto cleanup;
+        if( psize )
+            *psize = 0;
+    }
+    else
+    {
+        if( !(data = fileutil_read_fd(file, psize)) )
+            log_warning("%s: read failed", path);
+        close(file);
     }
 
+    return data;
+}
+
+/** Read content of an open file as string
+ *
+ * Reads from the current file offset up to end of file.
+ *
+ * @param fd     file descriptor open for reading
+ * @param psize  where to store content size
+ *
+ * @return NUL terminated content to be released via free(),
+ *         or NULL on failure
+ */
+char *
+fileutil_read_fd(int fd, size_t *psize)
+{
+    bool    ack  = false;
+    size_t  done = 0;
+    size_t  size = 0x1000;
+    char   *data = xmalloc(size);
+
     for( ;; ) {
         if( done == size )
             data = xrealloc(data, (size *= 2));
 
-        int rc = read(file, data + done, size - done);
+        ssize_t rc = read(fd, data + done, size - done);
 
         if( rc == -1 ) {
-            log_warning("%s: read: %m", path);
+            if( errno == EINTR )
+                continue;
+            log_warning("read: %m");
             goto cleanup;
         }
 
@@ -222,9 +250,6 @@ fileutil_read(const char *path, size_t *psize)
     ack = true;
 
 cleanup:
-    if( file != -1 )
-        close(file);
-
     if( !ack )
         free(data), data = 0, size = 0;
 
@@ -44,5 +44,6 @@ int    strutil_equals(const char *s1, const char *s2);
 
 bool  fileutil_exists(const char *path);
 char *fileutil_read  (const char *path, size_t *psize);
+char *fileutil_read_fd(int fd, size_t *psize);
 
 #endif /* UTIL_H_ */
@@ -8,6 +8,7 @@ URL:        https://github.com/sailfishos/ssu-sysinfo/
 Source0:    %{name}-%{version}.tar.bz2
 Requires(post): /sbin/ldconfig
 Requires(postun): /sbin/ldconfig
+BuildRequires: pkgconfig(systemd)
 
 %description
 This package contains command line tools and libraries for
@@ -32,17 +33,32 @@ unset LD_AS_NEEDED
 make _LIBDIR=%{_libdir} %{_smp_mflags}
 
 %install
-make _LIBDIR=%{_libdir} install DESTDIR=%{buildroot}
+make _LIBDIR=%{_libdir} _UNITDIR=%{_unitdir} install DESTDIR=%{buildroot}
 
-%post -p /sbin/ldconfig
+%post
+/sbin/ldconfig
+%{_bindir}/ssu-sysinfo --compile-board-mappings || :
+%{_bindir}/ssu-sysinfo --write-snapshot || :
 
 %postun -p /sbin/ldconfig
 
+%filetriggerin -- /usr/share/ssu/board-mappings.d
+%{_bindir}/ssu-sysinfo --compile-board-mappings || :
+
+%filetriggerpostun -- /usr/share/ssu/board-mappings.d
+%{_bindir}/ssu-sysinfo --compile-board-mappings || :
+
 %files
 %defattr(-,root,root,-)
 %license COPYING LICENSE.BSD-3CLAUSE LICENSE.LGPL-v2.1
 %{_libdir}/libssusysinfo.so.*
 %{_bindir}/ssu-sysinfo
+%dir %{_localstatedir}/cache/ssu-sysinfo
+%ghost %{_localstatedir}/cache/ssu-sysinfo/board-mappings.db
+%{_unitdir}/ssu-sysinfo-snapshot.service
+%{_unitdir}/ssu-sysinfo-snapshot.path
+%{_unitdir}/basic.target.wants/ssu-sysinfo-snapshot.service
+%{_unitdir}/paths.target.wants/ssu-sysinfo-snapshot.path
 
 %files devel
 %defattr(-,root,root,-)
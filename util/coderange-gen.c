@@ -0,0 +1,190 @@
+/** @file coderange-gen.c
+ *
+ * ssu-sysinfo - Code range table generator
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Reads codes from stdin, one per line in ascending order, and writes
+ * a C header with tables for mapping codes to their line numbers, i.e.
+ * indices in the table they were extracted from.
+ *
+ * Codes are grouped into ranges that are dense enough to be indexed
+ * directly. Each range descriptor has the first code, the number of
+ * codes and the offset of the range in a shared index array. Codes
+ * within a range that are not in the table map to CODERANGE_NONE.
+ *
+ * The including file must define <symbol>_range_t with members
+ * first, count and base.
+ *
+ * Usage: coderange-gen <symbol> < codes > header
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Gaps longer than this start a new range */
+#define CODERANGE_GEN_MAX_GAP 32
+
+/** Index value for codes that are not in the table */
+#define CODERANGE_NONE 0xffff
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static void      gen_fail   (const char *msg, const char *arg);
+static uint32_t *gen_read   (size_t *pcount);
+static void      gen_upper  (const char *symbol);
+int              main       (int argc, char **argv);
+
+/* ========================================================================= *
+ * Generator
+ * ========================================================================= */
+
+/** Report error and exit
+ */
+static void
+gen_fail(const char *msg, const char *arg)
+{
+    fprintf(stderr, "coderange-gen: %s%s%s\n", msg, arg ? ": " : "", arg ?: "");
+    exit(EXIT_FAILURE);
+}
+
+/** Read codes from stdin
+ */
+static uint32_t *
+gen_read(size_t *pcount)
+{
+    uint32_t *codes = 0;
+    size_t    count = 0;
+    char      line[64];
+
+    while( fgets(line, sizeof line, stdin) ) {
+        char *end = 0;
+        unsigned long code = strtoul(line, &end, 0);
+
+        if( end == line )
+            continue;
+
+        if( count > 0 && code <= codes[count - 1] )
+            gen_fail("codes not in ascending order", line);
+
+        if( !(codes = realloc(codes, (count + 1) * sizeof *codes)) )
+            gen_fail("out of memory", 0);
+        codes[count++] = (uint32_t)code;
+    }
+
+    *pcount = count;
+    return codes;
+}
+
+/** Write symbol in upper case
+ */
+static void
+gen_upper(const char *symbol)
+{
+    for( const char *pos = symbol; *pos; ++pos )
+        putchar(toupper((unsigned char)*pos));
+}
+
+/* ========================================================================= *
+ * Main
+ * ========================================================================= */
+
+int
+main(int argc, char **argv)
+{
+    if( argc != 2 )
+        gen_fail("usage: coderange-gen <symbol> < codes > header", 0);
+
+    const char *symbol = argv[1];
+    size_t      count  = 0;
+    uint32_t   *codes  = gen_read(&count);
+
+    if( count == 0 || count >= CODERANGE_NONE )
+        gen_fail("unsupported number of codes", 0);
+
+    /* Split into ranges at long gaps */
+    size_t *start  = calloc(count + 1, sizeof *start);
+    size_t  ranges = 0;
+
+    if( !start )
+        gen_fail("out of memory", 0);
+
+    for( size_t i = 0; i < count; ++i ) {
+        if( i == 0 || codes[i] - codes[i - 1] > CODERANGE_GEN_MAX_GAP )
+            start[ranges++] = i;
+    }
+    start[ranges] = count;
+
+    printf("/* Generated by util/coderange-gen - do not edit */\n\n");
+
+    printf("#define ");
+    gen_upper(symbol);
+    printf("_RANGE_CODES %zu\n", count);
+    printf("#define ");
+    gen_upper(symbol);
+    printf("_RANGE_NONE  0x%x\n\n", CODERANGE_NONE);
+
+    printf("static const %s_range_t %s_ranges[%zu] =\n{\n",
+           symbol, symbol, ranges);
+
+    size_t base = 0;
+    for( size_t r = 0; r < ranges; ++r ) {
+        uint32_t first = codes[start[r]];
+        uint32_t last  = codes[start[r + 1] - 1];
+        printf("    { .first = 0x%08x, .count = %4u, .base = %4zu },\n",
+               first, last - first + 1, base);
+        base += last - first + 1;
+    }
+    printf("};\n\n");
+
+    if( base >= CODERANGE_NONE )
+        gen_fail("index array too large", symbol);
+
+    printf("static const uint16_t %s_range_index[%zu] =\n{", symbol, base);
+
+    size_t k = 0;
+    for( size_t r = 0; r < ranges; ++r ) {
+        uint32_t first = codes[start[r]];
+        uint32_t last  = codes[start[r + 1] - 1];
+        size_t   i     = start[r];
+
+        for( uint32_t code = first; ; ++code ) {
+            unsigned index = CODERANGE_NONE;
+            if( codes[i] == code )
+                index = (unsigned)i++;
+            printf("%s%u,", (k++ % 12) ? " " : "\n    ", index);
+            if( code == last )
+                break;
+        }
+    }
+    printf("\n};\n");
+
+    free(start);
+    free(codes);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,266 @@
+/** @file namehash-gen.c
+ *
+ * ssu-sysinfo - Minimal perfect hash table generator
+ * <p>
+ * Copyright (c) 2026 Jolla Ltd.
+ *
+ * ssu-sysinfo is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * ssu-sysinfo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with ssu-sysinfo; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/* Reads names from stdin, one per line, and writes a C header with a
+ * namehash_t table that maps each name to its line number, i.e. the
+ * index of the name in the table it was extracted from.
+ *
+ * Usage: namehash-gen <symbol> < names > header
+ */
+
+#include "../lib/namehash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+/* ========================================================================= *
+ * Config
+ * ========================================================================= */
+
+/** Average number of names per bucket */
+#define NAMEHASH_GEN_LOAD 3
+
+/** Number of seeds to try before giving up */
+#define NAMEHASH_GEN_SEEDS 1000
+
+/* ========================================================================= *
+ * Prototypes
+ * ========================================================================= */
+
+static void  gen_fail   (const char *msg, const char *arg);
+static char **gen_read  (size_t *pcount);
+static int   gen_size_cb(const void *pa, const void *pb);
+static bool  gen_try    (char **names, uint32_t count, uint32_t buckets,
+                         uint32_t seed, uint16_t *disp, uint16_t *slot);
+static void  gen_emit   (const char *symbol, uint32_t count, uint32_t buckets,
+                         uint32_t seed, const uint16_t *disp,
+                         const uint16_t *slot);
+int          main       (int argc, char **argv);
+
+/* ========================================================================= *
+ * Generator
+ * ========================================================================= */
+
+/** Bucket sizes, for use from gen_size_cb() */
+static uint32_t *gen_bucket_size = 0;
+
+/** Report error and exit
+ */
+static void
+gen_fail(const char *msg, const char *arg)
+{
+    fprintf(stderr, "namehash-gen: %s%s%s\n", msg, arg ? ": " : "", arg ?: "");
+    exit(EXIT_FAILURE);
+}
+
+/** Read non-empty lines from stdin
+ */
+static char **
+gen_read(size_t *pcount)
+{
+    char    **names = 0;
+    size_t    count = 0;
+    char      line[256];
+
+    while( fgets(line, sizeof line, stdin) ) {
+        line[strcspn(line, "\r\n")] = 0;
+        if( !*line )
+            continue;
+
+        for( size_t i = 0; i < count; ++i ) {
+            if( !strcasecmp(names[i], line) )
+                gen_fail("duplicate name", line);
+        }
+
+        if( !(names = realloc(names, (count + 1) * sizeof *names)) ||
+            !(names[count] = strdup(line)) )
+            gen_fail("out of memory", 0);
+        ++count;
+    }
+
+    *pcount = count;
+    return names;
+}
+
+/** Sort bucket indices by descending number of members
+ */
+static int
+gen_size_cb(const void *pa, const void *pb)
+{
+    uint32_t a = gen_bucket_size[*(const uint32_t *)pa];
+    uint32_t b = gen_bucket_size[*(const uint32_t *)pb];
+    return (a < b) - (a > b);
+}
+
+/** Try to find displacement values for all buckets using given seed
+ *
+ * Buckets are placed largest first, each with the first displacement
+ * value that maps all of its members to distinct free slots.
+ */
+static bool
+gen_try(char **names, uint32_t count, uint32_t buckets, uint32_t seed,
+        uint16_t *disp, uint16_t *slot)
+{
+    bool      ack    = false;
+    uint64_t *hash   = calloc(count, sizeof *hash);
+    uint32_t *owner  = calloc(count, sizeof *owner);
+    uint32_t *order  = calloc(buckets, sizeof *order);
+    uint32_t *member = calloc(count, sizeof *member);
+    uint32_t *pick   = calloc(count, sizeof *pick);
+    bool     *used   = calloc(count, sizeof *used);
+
+    gen_bucket_size = calloc(buckets, sizeof *gen_bucket_size);
+
+    if( !hash || !owner || !order || !member || !pick || !used ||
+        !gen_bucket_size )
+        gen_fail("out of memory", 0);
+
+    for( uint32_t i = 0; i < count; ++i ) {
+        hash[i]  = namehash_fold(names[i], seed);
+        owner[i] = namehash_bucket(hash[i], buckets);
+        gen_bucket_size[owner[i]] += 1;
+    }
+
+    for( uint32_t b = 0; b < buckets; ++b )
+        order[b] = b;
+    qsort(order, buckets, sizeof *order, gen_size_cb);
+
+    for( uint32_t k = 0; k < buckets; ++k ) {
+        uint32_t b = order[k];
+        uint32_t n = 0;
+
+        disp[b] = 0;
+
+        for( uint32_t i = 0; i < count; ++i ) {
+            if( owner[i] == b )
+                member[n++] = i;
+        }
+        if( n == 0 )
+            continue;
+
+        uint32_t d = 0;
+        for( ; d <= UINT16_MAX; ++d ) {
+            uint32_t j = 0;
+            for( ; j < n; ++j ) {
+                pick[j] = namehash_slot(hash[member[j]], d, count);
+                bool clash = used[pick[j]];
+                for( uint32_t p = 0; !clash && p < j; ++p )
+                    clash = pick[p] == pick[j];
+                if( clash )
+                    break;
+            }
+            if( j == n )
+                break;
+        }
+        if( d > UINT16_MAX )
+            goto EXIT;
+
+        disp[b] = (uint16_t)d;
+        for( uint32_t j = 0; j < n; ++j ) {
+            used[pick[j]] = true;
+            slot[pick[j]] = (uint16_t)member[j];
+        }
+    }
+
+    ack = true;
+
+EXIT:
+    free(gen_bucket_size), gen_bucket_size = 0;
+    free(used);
+    free(pick);
+    free(member);
+    free(order);
+    free(owner);
+    free(hash);
+
+    return ack;
+}
+
+/** Write the tables as C source
+ */
+static void
+gen_emit(const char *symbol, uint32_t count, uint32_t buckets, uint32_t seed,
+         const uint16_t *disp, const uint16_t *slot)
+{
+    printf("/* Generated by util/namehash-gen - do not edit */\n\n");
+
+    printf("#define ");
+    for( const char *pos = symbol; *pos; ++pos )
+        putchar(toupper((unsigned char)*pos));
+    printf("_HASH_COUNT %u\n\n", count);
+
+    printf("static const uint16_t %s_hash_disp[%u] =\n{", symbol, buckets);
+    for( uint32_t i = 0; i < buckets; ++i )
+        printf("%s%u,", (i % 12) ? " " : "\n    ", disp[i]);
+    printf("\n};\n\n");
+
+    printf("static const uint16_t %s_hash_slot[%u] =\n{", symbol, count);
+    for( uint32_t i = 0; i < count; ++i )
+        printf("%s%u,", (i % 12) ? " " : "\n    ", slot[i]);
+    printf("\n};\n\n");
+
+    printf("static const namehash_t %s_hash =\n{\n", symbol);
+    printf("    .nh_seed    = 0x%08x,\n", seed);
+    printf("    .nh_buckets = %u,\n", buckets);
+    printf("    .nh_count   = %u,\n", count);
+    printf("    .nh_disp    = %s_hash_disp,\n", symbol);
+    printf("    .nh_slot    = %s_hash_slot,\n", symbol);
+    printf("};\n");
+}
+
+/* ========================================================================= *
+ * Main
+ * ========================================================================= */
+
+int
+main(int argc, char **argv)
+{
+    if( argc != 2 )
+        gen_fail("usage: namehash-gen <symbol> < names > header", 0);
+
+    size_t  count = 0;
+    char  **names = gen_read(&count);
+
+    if( count == 0 || count > UINT16_MAX )
+        gen_fail("unsupported number of names", 0);
+
+    uint32_t  buckets = (uint32_t)count / NAMEHASH_GEN_LOAD + 1;
+    uint16_t *disp    = calloc(buckets, sizeof *disp);
+    uint16_t *slot    = calloc(count, sizeof *slot);
+
+    if( !disp || !slot )
+        gen_fail("out of memory", 0);
+
+    for( uint32_t seed = 1; seed <= NAMEHASH_GEN_SEEDS; ++seed ) {
+        if( !gen_try(names, (uint32_t)count, buckets, seed, disp, slot) )
+            continue;
+
+        gen_emit(argv[1], (uint32_t)count, buckets, seed, disp, slot);
+        return EXIT_SUCCESS;
+    }
+
+    gen_fail("could not find perfect hash for", argv[1]);
+    return EXIT_FAILURE;
+}